@@ -0,0 +1,84 @@
+#ifdef OLED_ENABLE
+#include "anim.h"
+
+#include <string.h>
+
+/*
+ * a delta starts with a byte holding one bit per page it changes. for
+ * each of those pages, top first, runs follow that together cover the
+ * page's OLED_DISPLAY_WIDTH columns:
+ *
+ *     0x80 | (n - 1)           the next n columns are unchanged
+ *     n - 1, then n bytes      xor these into the next n columns
+ *
+ * the bytes are xor'd into the layer, and only the runs that changed
+ * are marked for the compositor.
+ */
+#define ANIM_SKIP 0x80
+
+#if OLED_DISPLAY_HEIGHT > 64
+#error "anim deltas only have a page mask for up to 8 pages"
+#endif
+
+void anim_init(anim_t *a)
+{
+    memset(a->layer->buf, 0, a->layer->pages * a->layer->width);
+    for (uint8_t page = 0; page < a->layer->pages; page++) {
+        comp_dirty(a->layer, page, 0, a->layer->width);
+    }
+
+    a->next = 0;
+    a->last = timer_read() - a->frametime;
+}
+
+void anim_step(anim_t *a)
+{
+    const uint8_t *p;
+    uint8_t *row;
+    uint8_t pages;
+    uint8_t token;
+    uint8_t run;
+
+    p = a->data + a->next;
+
+    pages = pgm_read_byte(p++);
+    for (uint8_t page = 0; page < a->layer->pages; page++) {
+        if (!(pages & (1 << page))) {
+            continue;
+        }
+
+        row = &a->layer->buf[page * OLED_DISPLAY_WIDTH];
+        for (uint8_t x = 0; x < OLED_DISPLAY_WIDTH; x += run) {
+            token = pgm_read_byte(p++);
+            run = (token & ~ANIM_SKIP) + 1;
+
+            if (token & ANIM_SKIP) {
+                continue;
+            }
+
+            for (uint8_t i = 0; i < run; i++) {
+                row[x + i] ^= pgm_read_byte(p++);
+            }
+
+            comp_dirty(a->layer, page, x, x + run);
+        }
+    }
+
+    a->next = p - a->data;
+    if (a->next >= a->size) {
+        a->next = a->loop;
+    }
+}
+
+bool anim_play(anim_t *a)
+{
+    if (timer_elapsed(a->last) < a->frametime) {
+        return false;
+    }
+
+    a->last = timer_read();
+    anim_step(a);
+
+    return true;
+}
+#endif
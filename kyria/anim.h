@@ -0,0 +1,44 @@
+#ifndef anim_h_INCLUDED
+#define anim_h_INCLUDED
+
+#ifdef OLED_ENABLE
+#ifndef QMK_EMULATOR
+#include QMK_KEYBOARD_H
+#else
+#include "emu/qmk.h"
+#endif
+
+#include "comp.h"
+
+typedef struct anim anim_t;
+
+/*
+ * a looping animation stored as xor deltas, see anim.c for the format
+ * and emu/animgen.c for the encoder. the first delta draws the first
+ * frame onto a blank display, the last leads back to the first frame.
+ */
+struct anim {
+    /* the deltas, back to back in PROGMEM */
+    const uint8_t *data;
+    uint16_t size;
+    /* offset of the delta after the first, where the loop restarts */
+    uint16_t loop;
+    /* ms between frames */
+    uint16_t frametime;
+    /* where the frames are drawn, as wide as the display */
+    comp_layer_t *layer;
+
+    /* offset of the next delta, and when the last one was applied */
+    uint16_t next;
+    uint16_t last;
+};
+
+/* blank the layer and start over */
+void anim_init(anim_t *a);
+/* draw the next frame */
+void anim_step(anim_t *a);
+/* draw the next frame if it is due, returns true when it was */
+bool anim_play(anim_t *a);
+
+#endif
+#endif // anim_h_INCLUDED
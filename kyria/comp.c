@@ -0,0 +1,196 @@
+#ifdef OLED_ENABLE
+#include "comp.h"
+
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define COMP_PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+/* columns composited at a time, in a row on the stack */
+#define COMP_CHUNK 16
+
+#if defined(COMP_STATS) && defined(QMK_EMULATOR)
+#include "emu/emu.h"
+#define CLOCK() emu_now()
+#else
+#define CLOCK() 0
+#endif
+
+#ifdef COMP_STATS
+#define STAT(l, name, n) ((l)->stats.name += (n))
+#else
+#define STAT(l, name, n) ((void)0)
+#endif
+
+static comp_layer_t *layers = NULL;
+
+/*
+ * columns lo to hi of each page, in display coordinates, that some
+ * layer changed since the last composite
+ */
+static uint8_t dirty_lo[COMP_PAGES];
+static uint8_t dirty_hi[COMP_PAGES];
+
+/* a bit per column of each page that a COMP_COPY layer hides */
+static uint8_t hidden[COMP_PAGES][OLED_DISPLAY_WIDTH / 8];
+
+void comp_add(comp_layer_t *l)
+{
+    comp_layer_t **p;
+
+    for (p = &layers; *p; p = &(*p)->next) {
+        if (*p == l) {
+            return;
+        }
+    }
+
+    l->next = NULL;
+    *p = l;
+
+    for (uint8_t page = 0; page < l->pages; page++) {
+        comp_dirty(l, page, 0, l->width);
+
+        if (l->blend != COMP_COPY || l->page + page >= COMP_PAGES) {
+            continue;
+        }
+        for (uint8_t x = l->x; x < MIN(l->x + l->width, OLED_DISPLAY_WIDTH); x++) {
+            hidden[l->page + page][x / 8] |= 1 << (x % 8);
+        }
+    }
+}
+
+void comp_dirty(comp_layer_t *l, uint8_t page, uint8_t lo, uint8_t hi)
+{
+    page += l->page;
+    if (page >= COMP_PAGES || lo >= hi) {
+        return;
+    }
+
+    if (dirty_lo[page] >= dirty_hi[page]) {
+        dirty_lo[page] = l->x + lo;
+        dirty_hi[page] = l->x + hi;
+    } else {
+        dirty_lo[page] = MIN(dirty_lo[page], l->x + lo);
+        dirty_hi[page] = MAX(dirty_hi[page], l->x + hi);
+    }
+}
+
+bool comp_hidden(uint8_t page, uint8_t x)
+{
+    return hidden[page][x / 8] & (1 << (x % 8));
+}
+
+comp_layer_t *comp_layers(void)
+{
+    return layers;
+}
+
+/*
+ * blend columns lo to hi of a page of every layer into row, which
+ * holds just those columns, bottom layer first, a layer at a time
+ */
+static void blend(uint8_t *row, uint8_t page, uint8_t lo, uint8_t hi)
+{
+    const uint8_t *src;
+    uint8_t *dst;
+    uint8_t from;
+    uint8_t to;
+    uint64_t start;
+
+    for (comp_layer_t *l = layers; l; l = l->next) {
+        if (!l->buf || page < l->page || page >= l->page + l->pages) {
+            continue;
+        }
+
+        from = MAX(lo, l->x);
+        to = MIN(hi, l->x + l->width);
+        if (from >= to) {
+            continue;
+        }
+
+        start = CLOCK();
+        src = &l->buf[(page - l->page) * l->width + (from - l->x)];
+        dst = &row[from - lo];
+
+        switch (l->blend) {
+            case COMP_OR:
+                for (uint8_t x = from; x < to; x++) {
+                    *dst++ |= *src++;
+                }
+                break;
+            case COMP_XOR:
+                for (uint8_t x = from; x < to; x++) {
+                    *dst++ ^= *src++;
+                }
+                break;
+            case COMP_MASK:
+                for (uint8_t x = from; x < to; x++) {
+                    *dst++ &= ~*src++;
+                }
+                break;
+            case COMP_COPY:
+                memcpy(dst, src, to - from);
+                break;
+        }
+
+        STAT(l, blended, to - from);
+        STAT(l, blend_ns, CLOCK() - start);
+        (void)start;
+    }
+}
+
+void comp_task(void)
+{
+    uint8_t row[COMP_CHUNK];
+    uint64_t start;
+    uint16_t base;
+    uint8_t lo;
+    uint8_t hi;
+    uint8_t n;
+
+    for (comp_layer_t *l = layers; l; l = l->next) {
+        if (l->update) {
+            start = CLOCK();
+            l->update();
+            STAT(l, updates, 1);
+            STAT(l, update_ns, CLOCK() - start);
+            (void)start;
+        }
+    }
+
+    for (uint8_t page = 0; page < COMP_PAGES; page++) {
+        lo = dirty_lo[page];
+        hi = MIN(dirty_hi[page], OLED_DISPLAY_WIDTH);
+        if (lo >= hi) {
+            continue;
+        }
+
+        base = page * OLED_DISPLAY_WIDTH;
+
+        for (uint8_t x = lo; x < hi; x += n) {
+            n = MIN(hi - x, COMP_CHUNK);
+
+            /* a bottom layer without a buffer is what the display holds */
+            if (layers && !layers->buf) {
+                memcpy(row, oled_read_raw(base + x).current_element, n);
+            } else {
+                memset(row, 0, n);
+            }
+            blend(row, page, x, x + n);
+
+            for (uint8_t i = 0; i < n; i++) {
+                oled_write_raw_byte(row[i], base + x + i);
+            }
+        }
+
+        dirty_lo[page] = 0;
+        dirty_hi[page] = 0;
+    }
+}
+#endif
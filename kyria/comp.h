@@ -0,0 +1,81 @@
+#ifndef comp_h_INCLUDED
+#define comp_h_INCLUDED
+
+#ifdef OLED_ENABLE
+#ifndef QMK_EMULATOR
+#include QMK_KEYBOARD_H
+#else
+#include "emu/qmk.h"
+#endif
+
+/* how a layer combines with the layers below it */
+enum comp_blend {
+    /* lit pixels light up */
+    COMP_OR,
+    /* lit pixels invert what's below */
+    COMP_XOR,
+    /* lit pixels blank what's below, to clear room for the layer above */
+    COMP_MASK,
+    /* the layer hides what's below, lit or not */
+    COMP_COPY,
+};
+
+typedef struct comp_layer comp_layer_t;
+
+#ifdef COMP_STATS
+typedef struct comp_stats comp_stats_t;
+
+/* what a layer cost since it was last cleared */
+struct comp_stats {
+    uint32_t updates;
+    /* bytes of the layer blended into the display */
+    uint32_t blended;
+    /* host time in update and in blending, emulator only */
+    uint64_t update_ns;
+    uint64_t blend_ns;
+};
+#endif
+
+/*
+ * a layer covers pages rows of width columns of the display, starting
+ * at column x of page page, and has a page packed buffer of that size.
+ * layers are composited bottom to top in the order they were added.
+ *
+ * the bottom layer can do without a buffer and draw straight into the
+ * display with oled_write_raw_byte, still marking what it changed. the
+ * layers above are then blended onto what it drew, so they can only be
+ * COMP_COPY: an or, xor or mask left on the display can't be undone
+ * when the layer changes. it leaves alone what they hide, see
+ * comp_hidden, or the bytes would change and change back, and be sent.
+ */
+struct comp_layer {
+    const char *name;
+    /* NULL for a bottom layer drawn straight into the display */
+    uint8_t *buf;
+    uint8_t x;
+    uint8_t page;
+    uint8_t width;
+    uint8_t pages;
+    uint8_t blend;
+    /* draws into buf and marks what changed with comp_dirty, or NULL */
+    void (*update)(void);
+
+    comp_layer_t *next;
+#ifdef COMP_STATS
+    comp_stats_t stats;
+#endif
+};
+
+/* put a layer on top of the others and composite all of it */
+void comp_add(comp_layer_t *l);
+/* columns lo to hi of a page of the layer changed, in layer coordinates */
+void comp_dirty(comp_layer_t *l, uint8_t page, uint8_t lo, uint8_t hi);
+/* whether a COMP_COPY layer hides column x of a page */
+bool comp_hidden(uint8_t page, uint8_t x);
+/* the bottom layer, the others follow through next */
+comp_layer_t *comp_layers(void);
+/* update every layer, then recomposite where any of them changed */
+void comp_task(void);
+
+#endif
+#endif // comp_h_INCLUDED
@@ -21,6 +21,16 @@
 #ifdef OLED_ENABLE
   #define OLED_DISPLAY_128X64
   #define OLED_DISPLAY_128X64
+  #ifdef RIPPLE_SYNC_ENABLE
+    // ripples spawned on the master are sent to the slave, see ripple.h
+    #define SPLIT_TRANSACTION_IDS_USER RIPPLE_SYNC
+  #endif
+  #ifdef STATUS_ENABLE
+    // the slave's status widgets show the master's layer, mods and leds
+    #define SPLIT_LAYER_STATE_ENABLE
+    #define SPLIT_MODS_ENABLE
+    #define SPLIT_LED_STATE_ENABLE
+  #endif
 #endif
 
 #ifdef RGBLIGHT_ENABLE
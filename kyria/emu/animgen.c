@@ -0,0 +1,266 @@
+/*
+ * generates pusheen_anim.h: the frames in pusheen.h as the xor deltas
+ * anim.c plays, one per frame and one more leading from the last frame
+ * back to the first.
+ *
+ * the deltas are then played through anim.c into a compositor layer on
+ * the emulated display, checking every frame against pusheen.h, and the
+ * sizes, i2c bytes per frame and decode time are reported on stderr.
+ *
+ * usage: animgen > pusheen_anim.h
+ */
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "emu.h"
+#include "../anim.h"
+#include "../comp.h"
+#include "../pusheen.h"
+
+#define PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+/* run tokens, see anim.c */
+#define SKIP 0x80
+#define RUN_MAX 128
+
+/* a delta that rewrites every byte, with a literal header every RUN_MAX */
+#define DELTA_MAX (1 + OLED_MATRIX_SIZE + OLED_MATRIX_SIZE / RUN_MAX)
+
+/* deltas played for the timing */
+#define TIMED_STEPS 100000
+
+static size_t zeros(const uint8_t *d, size_t x)
+{
+    size_t n;
+
+    for (n = 0; x + n < OLED_DISPLAY_WIDTH && !d[x + n]; n++)
+        ;
+
+    return n;
+}
+
+/*
+ * runs for one page of xor'd bytes. a single unchanged column between
+ * changed ones costs a byte either way, so it stays in the literal
+ * rather than splitting it.
+ */
+static size_t encodepage(uint8_t *out, const uint8_t *d)
+{
+    size_t len;
+    size_t x;
+    size_t n;
+    size_t z;
+
+    len = 0;
+    x = 0;
+    while (x < OLED_DISPLAY_WIDTH) {
+        n = zeros(d, x);
+        if (n) {
+            n = n < RUN_MAX ? n : RUN_MAX;
+            out[len++] = SKIP | (n - 1);
+            x += n;
+            continue;
+        }
+
+        n = 1;
+        while (n < RUN_MAX && x + n < OLED_DISPLAY_WIDTH) {
+            z = zeros(d, x + n);
+            if (z == 0) {
+                n++;
+            } else if (z == 1 && x + n + 1 < OLED_DISPLAY_WIDTH && n + 2 <= RUN_MAX) {
+                n += 2;
+            } else {
+                break;
+            }
+        }
+
+        out[len++] = n - 1;
+        memcpy(&out[len], &d[x], n);
+        len += n;
+        x += n;
+    }
+
+    return len;
+}
+
+/* pages any frame uses, the layer doesn't need the rest */
+static int used = 0;
+
+static size_t encode(uint8_t *out, const uint8_t *from, const uint8_t *to)
+{
+    uint8_t d[OLED_DISPLAY_WIDTH];
+    size_t len;
+    bool changed;
+
+    out[0] = 0;
+    len = 1;
+
+    for (int page = 0; page < PAGES; page++) {
+        changed = false;
+        for (int x = 0; x < OLED_DISPLAY_WIDTH; x++) {
+            d[x] = from[page * OLED_DISPLAY_WIDTH + x] ^ to[page * OLED_DISPLAY_WIDTH + x];
+            changed |= d[x] != 0;
+        }
+
+        if (changed) {
+            out[0] |= 1 << page;
+            len += encodepage(&out[len], d);
+            used = page + 1 > used ? page + 1 : used;
+        }
+    }
+
+    return len;
+}
+
+static const uint8_t *frame(size_t i)
+{
+    return pusheen[i % FRAMECOUNT];
+}
+
+/*
+ * play every delta on the emulated display and compare against the
+ * frames, twice round so the loop back is checked too
+ */
+static void check(anim_t *a)
+{
+    uint32_t bus;
+
+    oled_clear();
+    oled_render();
+    anim_init(a);
+    comp_task();
+    oled_render();
+
+    bus = 0;
+    for (size_t i = 0; i < 2 * FRAMECOUNT; i++) {
+        anim_step(a);
+        comp_task();
+        oled_render();
+
+        if (memcmp(emu_framebuffer(), frame(i), OLED_MATRIX_SIZE) != 0) {
+            errx(1, "frame %zu decodes wrong", i % FRAMECOUNT);
+        }
+
+        /* the second time round, every frame follows another */
+        if (i >= FRAMECOUNT) {
+            bus += emu_bus_bytes();
+        }
+    }
+
+    /* a whole frame, for comparison, is every block and its overhead */
+    oled_clear();
+    oled_render();
+
+    fprintf(stderr, "anim: %" PRIu32 " i2c bytes/frame played, %" PRIu32 " redrawing whole frames\n",
+        bus / (uint32_t)FRAMECOUNT, emu_bus_bytes());
+}
+
+static void timing(anim_t *a)
+{
+    uint64_t start;
+    uint64_t ns;
+
+    anim_init(a);
+
+    start = emu_now();
+    for (size_t i = 0; i < TIMED_STEPS; i++) {
+        anim_step(a);
+    }
+    ns = emu_now() - start;
+
+    fprintf(stderr, "anim: %.1f ns/frame decoding into the layer\n", (double)ns / TIMED_STEPS);
+}
+
+int main(void)
+{
+    static uint8_t blank[OLED_MATRIX_SIZE];
+    uint8_t *data;
+    size_t *offset;
+    size_t deltas;
+    size_t len;
+    comp_layer_t layer;
+    anim_t a;
+
+    /* one delta per frame and one back to the first */
+    deltas = FRAMECOUNT + 1;
+
+    data = malloc(deltas * DELTA_MAX);
+    offset = calloc(deltas + 1, sizeof(*offset));
+    if (!data || !offset) {
+        err(1, "malloc");
+    }
+
+    len = 0;
+    for (size_t i = 0; i < deltas; i++) {
+        offset[i] = len;
+        len += encode(&data[len], i ? frame(i - 1) : blank, frame(i));
+    }
+    offset[deltas] = len;
+
+    if (len > UINT16_MAX) {
+        errx(1, "animation of %zu bytes is too large", len);
+    }
+
+    printf("#ifndef pusheen_anim_h_INCLUDED\n");
+    printf("#define pusheen_anim_h_INCLUDED\n\n");
+    printf("/* generated by emu/animgen.c from pusheen.h, do not edit */\n\n");
+    printf("/* where the loop restarts, after the first frame */\n");
+    printf("#define PUSHEEN_ANIM_LOOP %zu\n", offset[1]);
+    printf("/* pages from the top the frames cover */\n");
+    printf("#define PUSHEEN_ANIM_PAGES %d\n\n", used);
+
+    printf("static const uint8_t PROGMEM pusheen_anim[] = {\n");
+    for (size_t i = 0; i < deltas; i++) {
+        if (i == 0) {
+            printf("    // frame 0, from a blank display");
+        } else if (i == FRAMECOUNT) {
+            printf("    // back to frame 0");
+        } else {
+            printf("    // frame %zu", i);
+        }
+
+        for (size_t j = offset[i]; j < offset[i + 1]; j++) {
+            printf("%s0x%02x,", (j - offset[i]) % 16 ? " " : "\n    ", data[j]);
+        }
+        printf("\n");
+    }
+    printf("};\n\n");
+
+    printf("#endif // pusheen_anim_h_INCLUDED\n");
+
+    fprintf(stderr, "anim: %zu frames, %zu bytes of deltas (%zu raw)\n",
+        (size_t)FRAMECOUNT, len, sizeof(pusheen));
+    for (size_t i = 0; i < deltas; i++) {
+        fprintf(stderr, "anim:   delta %zu: %zu bytes, pages 0x%02x\n",
+            i, offset[i + 1] - offset[i], data[offset[i]]);
+    }
+
+    layer = (comp_layer_t){
+        .name = "pusheen",
+        .buf = calloc(used, OLED_DISPLAY_WIDTH),
+        .width = OLED_DISPLAY_WIDTH,
+        .pages = used,
+    };
+    if (!layer.buf) {
+        err(1, "calloc");
+    }
+    comp_add(&layer);
+
+    a = (anim_t){
+        .data = data,
+        .size = len,
+        .loop = offset[1],
+        .layer = &layer,
+    };
+    check(&a);
+    timing(&a);
+
+    free(layer.buf);
+    free(offset);
+    free(data);
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * generates ripple_atlas.h: one page packed bitmap per ring radius,
+ * holding the lower right quadrant of the ring exactly as bresenham
+ * in ripple.c would plot it. ripple.c mirrors it into the other three
+ * quadrants when blitting.
+ *
+ * a column of a thin ring only covers a page or two, so each column
+ * is trimmed to its non empty pages: one byte holding the first page
+ * in the low nibble and the page count in the high nibble, followed
+ * by that many bitmap bytes.
+ *
+ * usage: atlasgen <max radius> > ripple_atlas.h
+ */
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* largest quadrant: (r + 1) columns of (r / 8 + 1) pages */
+#define QUADRANT_MAX(r) (((r) + 1) * ((r) / 8 + 1))
+
+/* largest radius whose columns' first page and page count fit a nibble */
+#define RADIUS_MAX (15 * 8 - 1)
+
+static void plot(uint8_t *quad, int pages, int x, int y)
+{
+    quad[x * pages + y / 8] |= 1 << (y % 8);
+}
+
+/*
+ * same walk as putcircle, keeping the two points of each step that
+ * land in the lower right quadrant
+ */
+static void quadrant(uint8_t *quad, int r)
+{
+    int x, y, d;
+    int pages;
+
+    pages = r / 8 + 1;
+    memset(quad, 0, QUADRANT_MAX(r));
+
+    x = 0;
+    y = r;
+
+    d = 3 - 2 * r;
+
+    while (y >= x) {
+        plot(quad, pages, x, y);
+        plot(quad, pages, y, x);
+        x++;
+
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t *quad;
+    uint8_t *col;
+    uint32_t *offset;
+    uint32_t total;
+    uint32_t raw;
+    int radius;
+    int pages;
+    int first;
+    int last;
+
+    if (argc != 2) {
+        errx(1, "usage: %s <max radius>", argv[0]);
+    }
+
+    radius = atoi(argv[1]);
+    if (radius < 0 || radius > RADIUS_MAX) {
+        errx(1, "radius must be between 0 and %d", RADIUS_MAX);
+    }
+
+    quad = malloc(QUADRANT_MAX(radius));
+    offset = calloc(radius + 1, sizeof(*offset));
+    if (!quad || !offset) {
+        err(1, "malloc");
+    }
+
+    printf("#ifndef ripple_atlas_h_INCLUDED\n");
+    printf("#define ripple_atlas_h_INCLUDED\n\n");
+    printf("/* generated by emu/atlas.c, do not edit */\n\n");
+    printf("#define RIPPLE_ATLAS_RADIUS %d\n\n", radius);
+
+    printf("static const uint8_t PROGMEM ripple_atlas[] = {\n");
+
+    raw = 0;
+    total = 0;
+    for (int r = 0; r <= radius; r++) {
+        pages = r / 8 + 1;
+        offset[r] = total;
+        quadrant(quad, r);
+
+        printf("    // r = %d", r);
+        for (int x = 0; x <= r; x++) {
+            col = &quad[x * pages];
+
+            for (first = 0; first < pages - 1 && !col[first]; first++)
+                ;
+            for (last = pages - 1; last > first && !col[last]; last--)
+                ;
+
+            printf("\n    0x%02x,", (last - first + 1) << 4 | first);
+            for (int j = first; j <= last; j++) {
+                printf(" 0x%02x,", col[j]);
+            }
+
+            total += 1 + last - first + 1;
+        }
+        printf("\n");
+
+        raw += QUADRANT_MAX(r);
+    }
+    printf("};\n\n");
+
+    if (total > UINT16_MAX) {
+        errx(1, "atlas of %lu bytes is too large", (unsigned long)total);
+    }
+
+    printf("static const uint16_t PROGMEM ripple_atlas_index[] = {");
+    for (int r = 0; r <= radius; r++) {
+        printf("%s%lu,", r % 8 ? " " : "\n    ", (unsigned long)offset[r]);
+    }
+    printf("\n};\n\n");
+
+    printf("#endif // ripple_atlas_h_INCLUDED\n");
+
+    fprintf(stderr, "atlas: radius 0-%d, %lu bytes bitmaps (%lu untrimmed) + %lu bytes index\n",
+        radius,
+        (unsigned long)total,
+        (unsigned long)raw,
+        (unsigned long)((radius + 1) * sizeof(uint16_t)));
+
+    free(offset);
+    free(quad);
+
+    return 0;
+}
@@ -0,0 +1,413 @@
+/*
+ * headless benchmark of the ripple renderer.
+ *
+ * for every scenario, the engine is reset, n ripples are spawned at
+ * fixed positions and the clock is moved to the given age, then one
+ * frame of the ripple layer is timed, drawing and compositing it.
+ * each scenario is sampled many times and the spread of ns/frame is
+ * reported with the work counted by RIPPLE_STATS (circles, bresenham
+ * steps, bytes written, pixels set and pixels clipped per frame), for
+ * every ring rasterizer.
+ *
+ * with -w, the water is timed instead, stepping and drawing a frame at
+ * a time as drops keep falling in, for every cell size, stepping the
+ * cells one by one and a word at a time.
+ *
+ * usage: ripplebench [-c] [-k] [-n samples] [-r render] [-w]
+ *
+ *   -c  instead of timing, check that every rasterizer draws the same
+ *       frames as the pixel one, pixel for pixel, and that the water
+ *       steps to the same heights a word at a time as one by one
+ *   -k  spawn the ripples in the corners, where most of every ring
+ *       is off the display
+ *   -n  samples per scenario (default 2000)
+ *   -r  only time this rasterizer: pixel, bytes or atlas
+ *   -w  time the water instead of the ripples
+ */
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "emu.h"
+#include "../ripple.h"
+#include "../water.h"
+
+/* ripple counts and ages in ms to measure */
+static const uint8_t counts[] = { 0, 1, 5, RIPPLE_MAX };
+static const uint16_t ages[] = { 200, 1000, 1400, 2600, 4000, 4900 };
+
+/* water cell sizes to measure, 2^shift px square */
+static const uint8_t shifts[] = { 0, 1, 2, 3 };
+
+/* water frames between drops */
+#define DROP_EVERY 16
+
+/* spacing between samples, comfortably more than a frame */
+#define SAMPLE_STEP 8192
+
+static int compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static bool corners = false;
+
+/*
+ * spread the centres over the display, or around its corners, the
+ * same ones every sample. main turns merging off, so every one of
+ * them spawns a ripple.
+ */
+static void spawn(uint8_t n)
+{
+    uint8_t x, y;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (corners) {
+            x = (i * 3) % 8;
+            y = (i * 5) % 6;
+
+            ripple_add(
+                i & 1 ? OLED_DISPLAY_WIDTH - 1 - x : x,
+                i & 2 ? OLED_DISPLAY_HEIGHT - 1 - y : y);
+        } else {
+            ripple_add(
+                (i * 37 + 20) % OLED_DISPLAY_WIDTH,
+                (i * 23 + 10) % OLED_DISPLAY_HEIGHT);
+        }
+    }
+
+    if (ripple_ctx()->alive != n) {
+        errx(1, "%u of %u ripples spawned", ripple_ctx()->alive, n);
+    }
+}
+
+static void scenario(uint8_t n, uint16_t age, uint64_t *ns, size_t samples)
+{
+    uint32_t t;
+    uint64_t start;
+
+    ripple_ctx()->stats = (ripple_stats_t){0};
+
+    for (size_t i = 0; i < samples; i++) {
+        t = i * SAMPLE_STEP;
+
+        emu_timer_set(t);
+        ripple_init();
+        oled_clear();
+        spawn(n);
+
+        emu_timer_set(t + age);
+        start = emu_now();
+        comp_task();
+        ns[i] = emu_now() - start;
+
+        oled_render();
+    }
+
+    qsort(ns, samples, sizeof(*ns), compare);
+
+    printf("%8s %8u %8u %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+        ripple_render_names[ripple_render],
+        n, age,
+        ns[0],
+        ns[samples / 2],
+        ns[samples * 99 / 100],
+        (double)ripple_ctx()->stats.circles / samples,
+        (double)ripple_ctx()->stats.steps / samples,
+        (double)ripple_ctx()->stats.writes / samples,
+        (double)ripple_ctx()->stats.pixels / samples,
+        (double)ripple_ctx()->stats.clipped / samples);
+}
+
+/*
+ * drop into the water every DROP_EVERY frames, at the same places
+ * every run
+ */
+static void drip(uint32_t frame)
+{
+    uint32_t i;
+
+    if (frame % DROP_EVERY) {
+        return;
+    }
+
+    i = frame / DROP_EVERY;
+    water_drop((i * 37 + 20) % OLED_DISPLAY_WIDTH, (i * 23 + 10) % OLED_DISPLAY_HEIGHT);
+}
+
+static void waterscenario(uint8_t shift, bool words, uint64_t *step, uint64_t *render, size_t samples)
+{
+    static uint8_t frame[OLED_MATRIX_SIZE];
+    uint64_t start;
+
+    water_shift = shift;
+    water_words = words;
+    water_init(frame);
+
+    for (size_t i = 0; i < samples; i++) {
+        drip(i);
+
+        start = emu_now();
+        water_step();
+        step[i] = emu_now() - start;
+
+        start = emu_now();
+        water_render();
+        render[i] = emu_now() - start;
+    }
+
+    qsort(step, samples, sizeof(*step), compare);
+    qsort(render, samples, sizeof(*render), compare);
+
+    printf("%8u %8u %8s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+        shift,
+        (OLED_DISPLAY_WIDTH >> shift) * (OLED_DISPLAY_HEIGHT >> shift),
+        words ? "words" : "cells",
+        step[0],
+        step[samples / 2],
+        step[samples * 99 / 100],
+        render[0],
+        render[samples / 2],
+        render[samples * 99 / 100]);
+}
+
+static void waterbench(size_t samples)
+{
+    uint64_t *step;
+    uint64_t *render;
+
+    step = calloc(samples, sizeof(*step));
+    render = calloc(samples, sizeof(*render));
+    if (!step || !render) {
+        err(1, "calloc");
+    }
+
+    printf("%8s %8s %8s %10s %10s %10s %10s %10s %10s\n",
+        "shift", "cells", "step", "step min", "median", "p99", "draw min", "median", "p99");
+
+    for (size_t i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+        waterscenario(shifts[i], false, step, render, samples);
+        waterscenario(shifts[i], true, step, render, samples);
+    }
+
+    free(render);
+    free(step);
+}
+
+/* fnv-1a of the water's heights */
+static uint64_t waterhash(uint8_t shift)
+{
+    const int8_t *h = water_cells();
+    uint64_t hash;
+
+    hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < (size_t)(OLED_DISPLAY_WIDTH >> shift) * (OLED_DISPLAY_HEIGHT >> shift); i++) {
+        hash ^= (uint8_t)h[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/*
+ * step the water for every cell size one by one and a word at a time,
+ * comparing the heights after every frame
+ */
+static bool checkwater(void)
+{
+    static uint8_t frame[OLED_MATRIX_SIZE];
+    static uint64_t expect[1000];
+    uint32_t frames;
+    uint32_t bad;
+
+    frames = 0;
+    bad = 0;
+
+    for (size_t i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+        water_shift = shifts[i];
+
+        for (int words = 0; words < 2; words++) {
+            water_words = words;
+            water_init(frame);
+
+            for (uint32_t t = 0; t < sizeof(expect) / sizeof(expect[0]); t++) {
+                drip(t);
+                water_step();
+
+                if (!words) {
+                    expect[t] = waterhash(shifts[i]);
+                    continue;
+                }
+
+                frames++;
+                if (waterhash(shifts[i]) != expect[t]) {
+                    warnx("water differs at shift %u, frame %" PRIu32, shifts[i], t);
+                    bad++;
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("%lu water frames compared, %lu differ\n",
+        (unsigned long)frames, (unsigned long)bad);
+
+    return bad == 0;
+}
+
+/*
+ * render ripples of every age at centres all over, and partly off,
+ * the display with each rasterizer, comparing against the pixel one
+ */
+static bool check(void)
+{
+    static uint8_t expect[OLED_MATRIX_SIZE];
+    uint32_t t;
+    uint32_t frames;
+    uint32_t bad;
+    uint8_t x, y;
+
+    frames = 0;
+    bad = 0;
+    t = 1;
+
+    for (uint16_t age = 0; age <= RIPPLE_TIMEOUT; age += 50) {
+        for (int i = 0; i < 64; i++) {
+            x = (i * 73 + age) % 256;
+            y = (i * 41 + age / 3) % 256;
+
+            for (uint8_t render = 0; render < RIPPLE_RENDER_COUNT; render++) {
+                ripple_render = render;
+
+                t += SAMPLE_STEP;
+                emu_timer_set(t);
+                ripple_init();
+                oled_clear();
+                ripple_add(x, y);
+                ripple_add(y / 2, x / 4);
+                if (ripple_ctx()->alive != 2) {
+                    errx(1, "%u of 2 ripples spawned at centres %u,%u and %u,%u",
+                        ripple_ctx()->alive, x, y, y / 2, x / 4);
+                }
+
+                emu_timer_set(t + age);
+                comp_task();
+                oled_render();
+
+                if (render == RIPPLE_RENDER_PIXEL) {
+                    memcpy(expect, emu_framebuffer(), sizeof(expect));
+                } else if (memcmp(expect, emu_framebuffer(), sizeof(expect)) != 0) {
+                    warnx("%s differs at age %u, centres %u,%u and %u,%u",
+                        ripple_render_names[render], age, x, y, y / 2, x / 4);
+                    bad++;
+                }
+
+                frames++;
+            }
+        }
+    }
+
+    printf("%lu frames compared, %lu differ\n",
+        (unsigned long)frames, (unsigned long)bad);
+
+    return bad == 0;
+}
+
+static uint8_t parserender(const char *name)
+{
+    for (uint8_t i = 0; i < RIPPLE_RENDER_COUNT; i++) {
+        if (strcmp(name, ripple_render_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    errx(1, "unknown render %s", name);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t *ns;
+    size_t samples;
+    uint8_t first;
+    uint8_t last;
+    bool checking;
+    bool water;
+    bool ok;
+    int opt;
+
+    samples = 2000;
+    first = 0;
+    last = RIPPLE_RENDER_COUNT - 1;
+    checking = false;
+    water = false;
+
+    comp_add(&ripple_layer);
+    ripple_stats_interval = 0;
+    /* close centres would merge and leave scenarios short of ripples */
+    ripple_merge_age = 0;
+
+    while ((opt = getopt(argc, argv, "ckn:r:w")) != -1) {
+        switch (opt) {
+            case 'c':
+                checking = true;
+                break;
+            case 'k':
+                corners = true;
+                break;
+            case 'n':
+                samples = strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                first = last = parserender(optarg);
+                break;
+            case 'w':
+                water = true;
+                break;
+            default:
+                errx(1, "usage: %s [-c] [-k] [-n samples] [-r render] [-w]", argv[0]);
+        }
+    }
+
+    if (checking) {
+        ok = check();
+        ok = checkwater() && ok;
+        return ok ? 0 : 1;
+    }
+
+    if (!samples) {
+        errx(1, "need at least one sample");
+    }
+
+    if (water) {
+        waterbench(samples);
+        return 0;
+    }
+
+    ns = calloc(samples, sizeof(*ns));
+    if (!ns) {
+        err(1, "calloc");
+    }
+
+    printf("%8s %8s %8s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+        "render", "ripples", "age ms", "min ns", "median ns", "p99 ns", "circles", "steps", "writes", "pixels", "clipped");
+
+    for (uint8_t render = first; render <= last; render++) {
+        ripple_render = render;
+
+        for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+            for (size_t j = 0; j < sizeof(ages) / sizeof(ages[0]); j++) {
+                scenario(counts[i], ages[j], ns, samples);
+            }
+        }
+    }
+
+    free(ns);
+
+    return 0;
+}
@@ -1,24 +1,80 @@
 CC := gcc
 
 TARGET := oled
+REPLAY := replay
+BENCH := ripplebench
+SPLIT := split
+SOAK := ripplesoak
+TYPIST := typist
 
-OBJ := qmk.o ../keymap.o ../ripple.o
-DEP := $(OBJ:.o=.d)
+ATLAS_GEN := atlasgen
+# largest ring radius with a precomputed bitmap, larger rings are rasterized
+ATLAS_RADIUS := 29
+
+ANIM_GEN := animgen
+
+# the firmware and the qmk shim, shared by every frontend
+COMMON := qmk.o ../keymap.o ../comp.o ../ripple.o ../anim.o ../water.o ../widget.o ../keystats.o
+
+OBJ := sdl.o record.o $(COMMON)
+REPLAY_OBJ := replay.o trace.o record.o $(COMMON)
+BENCH_OBJ := bench.o $(COMMON)
+SPLIT_OBJ := split.o trace.o $(COMMON)
+SOAK_OBJ := soak.o $(COMMON)
+TYPIST_OBJ := typist.o trace.o $(COMMON)
+ANIM_OBJ := animgen.o qmk.o ../comp.o ../anim.o
+DEP := $(sort $(OBJ:.o=.d) $(REPLAY_OBJ:.o=.d) $(BENCH_OBJ:.o=.d) $(SPLIT_OBJ:.o=.d) $(SOAK_OBJ:.o=.d) $(TYPIST_OBJ:.o=.d) $(ANIM_OBJ:.o=.d))
 
 CFLAGS := -std=c99
 CFLAGS += -Wall -Wpedantic -Wextra
 CFLAGS += -MMD
 CFLAGS += -D_GNU_SOURCE -DQMK_EMULATOR
-CFLAGS += -DMATRIX_ROWS=4 -DMATRIX_COLS=8
+# the kyria's matrix, rows 0-3 are the left half and 4-7 the right
+CFLAGS += -DMATRIX_ROWS=8 -DMATRIX_COLS=8
 CFLAGS += -DOLED_ENABLE -DCONSOLE_ENABLE
+CFLAGS += -DRIPPLE_STATS -DRIPPLE_ATLAS -DCOMP_STATS
+CFLAGS += -DRIPPLE_SYNC_ENABLE -DSPLIT_TRANSACTION_IDS_USER=RIPPLE_SYNC
 CFLAGS_DEBUG   := -O0 -ggdb
 CFLAGS_RELEASE := -O2
 
+ifeq ($(FADE_NOISE),1)
+CFLAGS += -DRIPPLE_FADE_NOISE
+endif
+
+ifeq ($(WATER),1)
+CFLAGS += -DWATER_ENABLE
+endif
+
+# the status widgets are opt in in rules.mk but on here, the golden
+# traces were recorded with them. STATUS=0 leaves them out
+ifneq ($(STATUS),0)
+CFLAGS += -DSTATUS_ENABLE
+endif
+
+ifeq ($(KEYSTATS),1)
+CFLAGS += -DKEYSTATS_ENABLE
+endif
+
+ifeq ($(PUSHEEN),1)
+CFLAGS += -DPUSHEEN_ENABLE -DRIPPLE_FRAME
+endif
+
+# give the ripples a frame of their own like PUSHEEN=1 does, rather
+# than drawing them straight into the display
+ifeq ($(FRAME),1)
+CFLAGS += -DRIPPLE_FRAME
+endif
+
+# drift the ripples SCROLL px a frame along x
+ifdef SCROLL
+CFLAGS += -DRIPPLE_SCROLL_X=$(SCROLL)
+endif
+
 ifeq ($(DEBUG),1)
 CFLAGS += $(CFLAGS_DEBUG)
 else
 CFLAGS += $(CFLAGS_RELEASE)
 endif
 
-LDLIBS := -lSDL2
+LDLIBS := -lSDL2 -lpthread
 LDFLAGS :=
@@ -0,0 +1,67 @@
+#ifndef emu_h_INCLUDED
+#define emu_h_INCLUDED
+
+#include "qmk.h"
+
+/*
+ * emulator side of the shim, used by the frontends but never by
+ * firmware code
+ */
+
+/* the display contents, OLED_MATRIX_SIZE bytes in ssd1306 page order */
+const uint8_t *emu_framebuffer(void);
+/* true when the display changed since the last oled_render */
+bool emu_dirty(void);
+/* i2c bytes the last oled_render would have cost */
+uint32_t emu_bus_bytes(void);
+
+/* host monotonic time in ns */
+uint64_t emu_now(void);
+
+/*
+ * timer_read's time source. the clock counts ms in 32 bits from start,
+ * and timer_read returns the low 16 like the firmware's timer, so a
+ * start just short of a multiple of 65536 wraps it early in a run.
+ */
+enum emu_clock {
+    /* host time, the default */
+    EMU_CLOCK_REAL,
+    /* host time, rate times as fast */
+    EMU_CLOCK_WARP,
+    /* rate ms on every emu_tick, however long the ticks take */
+    EMU_CLOCK_STEP,
+};
+
+void emu_set_clock(enum emu_clock kind, uint32_t rate, uint32_t start);
+/*
+ * set the clock from "real", "warp:<rate>" or "step:<ms>", each with
+ * an optional "@<start>", as the frontends take it. false if malformed.
+ */
+bool emu_parse_clock(const char *spec);
+/* move a step clock on, once per pass of the frontend's loop */
+void emu_tick(void);
+/* the clock's ms, before timer_read cuts them to 16 bits */
+uint32_t emu_clock_ms(void);
+/* make the clock a step clock standing at ms */
+void emu_timer_set(uint32_t ms);
+
+/* fnv-1a hash of the display contents */
+uint64_t emu_frame_hash(void);
+
+/* play the master or the slave half, the master by default */
+void emu_set_master(bool master);
+
+/* what get_mods and host_keyboard_led_state return, layer_state is set directly */
+void emu_set_mods(uint8_t mods);
+void emu_set_leds(led_t leds);
+
+/*
+ * where transaction_rpc_send goes on the master. without a link,
+ * transactions fail as if the slave was unplugged.
+ */
+typedef bool (*emu_link_t)(int8_t id, uint8_t len, const void *data);
+void emu_set_link(emu_link_t link);
+/* run a transaction that came over the link on the slave */
+bool emu_rpc(int8_t id, uint8_t len, const void *data);
+
+#endif // emu_h_INCLUDED
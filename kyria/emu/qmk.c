@@ -1,135 +1,336 @@
 #include <err.h>
 #include <time.h>
+#include <string.h>
 #include <stdbool.h>
 
-#include <SDL2/SDL.h>
+#include "emu.h"
 
-#include "qmk.h"
+/* page packed like the ssd1306 gdram: byte (y / 8) * width + x, bit y % 8 */
+static uint8_t oled_buffer[OLED_MATRIX_SIZE];
 
-typedef struct color color_t;
+/* dirty blocks, modelled on the qmk driver: one bit per OLED_BLOCK_SIZE bytes */
+#define OLED_BLOCK_COUNT 16
+#define OLED_BLOCK_SIZE  (OLED_MATRIX_SIZE / OLED_BLOCK_COUNT)
 
-struct color {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-    uint8_t a;
-};
+/*
+ * i2c bytes spent per block besides its data: address and control
+ * byte for the column/page window command and its 6 bytes, then
+ * address and control byte for the data transfer
+ */
+#define OLED_BLOCK_OVERHEAD (2 + 6 + 2)
 
-static inline color_t color(bool on)
+static uint16_t oled_dirty = 0;
+
+/* bytes sent by the last oled_render */
+static uint32_t bus_frame = 0;
+
+/*
+ * timer_read's clock, see emu_set_clock. a real or warp clock counts
+ * from start at origin in host ns, a step clock is at ticks.
+ */
+static uint8_t clock_kind = EMU_CLOCK_REAL;
+static uint32_t clock_rate = 1;
+static uint32_t clock_start = 0;
+static uint64_t clock_origin = 0;
+static uint32_t ticks = 0;
+
+static bool master = true;
+
+layer_state_t layer_state = 0;
+static uint8_t mods = 0;
+static led_t leds = {0};
+
+/* the slave's transaction handlers and the master's end of the link */
+static slave_callback_t rpc[NUM_TRANSACTIONS ? NUM_TRANSACTIONS : 1];
+static emu_link_t link = NULL;
+
+extern bool oled_task_kb(void) __attribute__ ((weak, alias ("_oled_task_kb")));
+extern bool oled_task_user(void) __attribute__ ((weak, alias ("_oled_task_user")));
+extern oled_rotation_t oled_init_user(oled_rotation_t rotation) __attribute__ ((weak, alias ("_oled_init_user")));
+extern bool process_record_user(uint16_t keycode, keyrecord_t *record) __attribute__ ((weak, alias ("_process_record_user")));
+extern void keyboard_post_init_user(void) __attribute__ ((weak, alias ("_keyboard_post_init_user")));
+extern void housekeeping_task_user(void) __attribute__ ((weak, alias ("_housekeeping_task_user")));
+
+void oled_clear(void)
+{
+    memset(oled_buffer, 0, sizeof(oled_buffer));
+    oled_dirty = UINT16_MAX;
+}
+
+static inline void mark(uint16_t index)
 {
+    oled_dirty |= (uint16_t)1 << (index / OLED_BLOCK_SIZE);
+}
+
+void oled_write_raw_byte(const char data, uint16_t index)
+{
+    if (index >= OLED_MATRIX_SIZE) {
+        return;
+    }
+
+    if (oled_buffer[index] == (uint8_t)data) {
+        return;
+    }
+
+    oled_buffer[index] = data;
+    mark(index);
+}
+
+oled_buffer_reader_t oled_read_raw(uint16_t start_index)
+{
+    if (start_index > OLED_MATRIX_SIZE - 1) {
+        start_index = OLED_MATRIX_SIZE - 1;
+    }
+
+    return (oled_buffer_reader_t){
+        .current_element = &oled_buffer[start_index],
+        .remaining_element_count = OLED_MATRIX_SIZE - start_index,
+    };
+}
+
+void oled_write_pixel(uint8_t x, uint8_t y, bool on)
+{
+    uint16_t index;
+    uint8_t data;
+
+    if (x >= OLED_DISPLAY_WIDTH || y >= OLED_DISPLAY_HEIGHT) {
+        return;
+    }
+
+    index = (y / 8) * OLED_DISPLAY_WIDTH + x;
+
+    data = oled_buffer[index];
     if (on) {
-        return (color_t){
-            .r = 214,
-            .g = 244,
-            .b = 255,
-            .a = 0xff
-        };
+        data |= (1 << (y % 8));
     } else {
-        return (color_t){
-            .r = 0x00,
-            .g = 0x00,
-            .b = 0x00,
-            .a = 0xff
-        };
+        data &= ~(1 << (y % 8));
+    }
+
+    if (oled_buffer[index] != data) {
+        oled_buffer[index] = data;
+        mark(index);
     }
 }
 
-const int SCREEN_WIDTH = 128;
-const int SCREEN_HEIGHT = 64;
+/*
+ * send the dirty blocks, counting what it would cost on the bus
+ */
+void oled_render(void)
+{
+    bus_frame = 0;
 
-static SDL_Window *win;
-static SDL_Renderer *ren = NULL;
-static bool dirty = true;
+    for (int i = 0; i < OLED_BLOCK_COUNT; i++) {
+        if (oled_dirty & ((uint16_t)1 << i)) {
+            bus_frame += OLED_BLOCK_OVERHEAD + OLED_BLOCK_SIZE;
+        }
+    }
 
-extern bool oled_task_kb(void) __attribute__ ((weak, alias ("_oled_task_kb")));
-extern bool oled_task_user(void) __attribute__ ((weak, alias ("_oled_task_user")));
-extern bool process_record_user(uint16_t keycode, keyrecord_t *record) __attribute__ ((weak, alias ("_process_record_user")));
+    oled_dirty = 0;
+}
+
+const uint8_t *emu_framebuffer(void)
+{
+    return oled_buffer;
+}
+
+bool emu_dirty(void)
+{
+    return oled_dirty != 0;
+}
+
+uint32_t emu_bus_bytes(void)
+{
+    return bus_frame;
+}
+
+uint64_t emu_now(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == -1) {
+        err(1, "clock_gettime");
+    }
+
+    return ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
 
-void init(void)
+void emu_set_clock(enum emu_clock kind, uint32_t rate, uint32_t start)
 {
-    SDL_Surface *surface;
+    clock_kind = kind;
+    clock_rate = rate;
+    clock_start = start;
+    clock_origin = emu_now();
+    ticks = start;
+}
 
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        err(1, "failed to initialize sdl");
+bool emu_parse_clock(const char *spec)
+{
+    static const char *const kinds[] = {
+        [EMU_CLOCK_REAL] = "real",
+        [EMU_CLOCK_WARP] = "warp",
+        [EMU_CLOCK_STEP] = "step",
+    };
+    unsigned long rate;
+    unsigned long start;
+    const char *p;
+    char *end;
+    size_t len;
+    uint8_t kind;
+
+    len = strcspn(spec, ":@");
+    for (kind = 0; kind < sizeof(kinds) / sizeof(kinds[0]); kind++) {
+        if (strlen(kinds[kind]) == len && strncmp(spec, kinds[kind], len) == 0) {
+            break;
+        }
+    }
+    if (kind == sizeof(kinds) / sizeof(kinds[0])) {
+        return false;
     }
 
-    win = SDL_CreateWindow(
-        "OLED",
-        SDL_WINDOWPOS_UNDEFINED,
-        SDL_WINDOWPOS_UNDEFINED,
-        SCREEN_WIDTH,
-        SCREEN_HEIGHT,
-        SDL_WINDOW_SHOWN);
+    p = spec + len;
+    rate = 1;
+    if (*p == ':' && kind != EMU_CLOCK_REAL) {
+        rate = strtoul(p + 1, &end, 10);
+        if (end == p + 1 || !rate) {
+            return false;
+        }
+        p = end;
+    }
 
-    if (!win) {
-        err(1, "failed to create window");
+    start = 0;
+    if (*p == '@') {
+        start = strtoul(p + 1, &end, 10);
+        if (end == p + 1) {
+            return false;
+        }
+        p = end;
     }
 
-    ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
-    if (!ren) {
-        err(1, "failed to create renderer");
+    if (*p) {
+        return false;
     }
 
-    SDL_SetRenderDrawColor(ren, 0, 0, 0, 0);
+    emu_set_clock(kind, rate, start);
+
+    return true;
+}
+
+void emu_tick(void)
+{
+    if (clock_kind == EMU_CLOCK_STEP) {
+        ticks += clock_rate;
+    }
+}
 
-    surface = SDL_GetWindowSurface(win);
-    SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0x00, 0x00, 0x00));
-    SDL_UpdateWindowSurface(win);
+uint32_t emu_clock_ms(void)
+{
+    switch (clock_kind) {
+        case EMU_CLOCK_WARP:
+            return clock_start + (emu_now() - clock_origin) * clock_rate / 1000000;
+        case EMU_CLOCK_STEP:
+            return ticks;
+        default:
+            return clock_start + (emu_now() - clock_origin) / 1000000;
+    }
 }
 
-void destroy(void)
+void emu_timer_set(uint32_t ms)
 {
-    SDL_DestroyWindow(win);
-    SDL_Quit();
+    clock_kind = EMU_CLOCK_STEP;
+    ticks = ms;
 }
 
-static void setcolor(color_t c)
+uint64_t emu_frame_hash(void)
 {
-    static color_t color = {0};
+    uint64_t h;
 
-    if (memcmp(&c, &color, sizeof(color)) != 0) {
-        SDL_SetRenderDrawColor(ren, c.r, c.g, c.b, c.a);
-        color = c;
+    h = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        h ^= oled_buffer[i];
+        h *= UINT64_C(0x100000001b3);
     }
+
+    return h;
 }
 
-void oled_clear(void)
+void emu_set_master(bool m)
 {
-    dirty = true;
+    master = m;
+}
 
-    setcolor(color(0));
-    SDL_RenderClear(ren);
+bool is_keyboard_master(void)
+{
+    return master;
 }
 
-static void flush(void)
+uint8_t get_highest_layer(layer_state_t state)
 {
-    SDL_RenderPresent(ren);
+    uint8_t layer;
+
+    for (layer = 0; state > 1; layer++) {
+        state >>= 1;
+    }
+
+    return layer;
 }
 
-static void putpixel(uint16_t x, uint16_t y, color_t c)
+void emu_set_mods(uint8_t m)
 {
-    setcolor(c);
-    SDL_RenderDrawPoint(ren, x, y);
+    mods = m;
 }
 
-void oled_write_pixel(uint8_t x, uint8_t y, bool on)
+uint8_t get_mods(void)
 {
-    dirty = true;
+    return mods;
+}
+
+void emu_set_leds(led_t l)
+{
+    leds = l;
+}
+
+led_t host_keyboard_led_state(void)
+{
+    return leds;
+}
 
-    if (x < SCREEN_WIDTH && y < SCREEN_HEIGHT) {
-        putpixel(x, y, color(on));
+void emu_set_link(emu_link_t l)
+{
+    link = l;
+}
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback)
+{
+    if (transaction_id >= 0 && transaction_id < NUM_TRANSACTIONS) {
+        rpc[transaction_id] = callback;
     }
 }
 
-uint16_t timer_read(void)
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer)
 {
-    struct timespec ts;
+    if (!master || !link || initiator2target_buffer_size > RPC_M2S_BUFFER_SIZE) {
+        return false;
+    }
 
-    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == -1) {
-        err(1, "clock_gettime");
+    return link(transaction_id, initiator2target_buffer_size, initiator2target_buffer);
+}
+
+bool emu_rpc(int8_t id, uint8_t len, const void *data)
+{
+    uint8_t reply[RPC_S2M_BUFFER_SIZE];
+
+    if (master || id < 0 || id >= NUM_TRANSACTIONS || !rpc[id]) {
+        return false;
     }
 
-    return (ts.tv_sec * 1000 + (ts.tv_nsec / 1000000)) & 0xffff;
+    rpc[id](len, data, sizeof(reply), reply);
+
+    return true;
+}
+
+uint16_t timer_read(void)
+{
+    return emu_clock_ms() & 0xffff;
 }
 
 uint16_t timer_elapsed(uint16_t last)
@@ -149,6 +350,11 @@ bool _oled_task_user(void)
     return true;
 }
 
+oled_rotation_t _oled_init_user(oled_rotation_t rotation)
+{
+    return rotation;
+}
+
 bool _process_record_user(uint16_t keycode, keyrecord_t *record)
 {
     (void)keycode;
@@ -156,44 +362,10 @@ bool _process_record_user(uint16_t keycode, keyrecord_t *record)
     return true;
 }
 
-int main()
+void _keyboard_post_init_user(void)
 {
-    keyrecord_t r;
-    SDL_Event ev;
-    bool quit;
-
-    init();
-    oled_task_user();
-    flush();
-
-    quit = false;
-    while (!quit) {
-        dirty = false;
-        oled_task_user();
-        if (dirty) {
-            flush();
-        }
-
-        while(SDL_PollEvent(&ev) != 0) {
-            if(ev.type == SDL_QUIT) {
-                quit = true;
-            } else if(ev.type == SDL_KEYDOWN || ev.type == SDL_KEYUP) {
-                memset(&r, 0, sizeof(r));
-                r.event.key.col = rand() % 8;
-                r.event.key.row = rand() % 4;
-                r.event.pressed = ev.type == SDL_KEYDOWN;
-                r.keycode = ev.key.keysym.sym;
-
-                process_record_user(ev.key.keysym.sym, &r);
-
-                switch (ev.key.keysym.sym) {
-                    case SDLK_q:
-                        quit = true;
-                        break;
-                }
-            }
-        }
-    }
+}
 
-    destroy();
+void _housekeeping_task_user(void)
+{
 }
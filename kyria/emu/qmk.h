@@ -7,12 +7,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 
-#define uprintf printf
+/* the console, kept apart from what the frontends print */
+#define uprintf(...) fprintf(stderr, __VA_ARGS__)
 
 #define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
 
 #define OLED_DISPLAY_WIDTH  128
 #define OLED_DISPLAY_HEIGHT 64
+#define OLED_MATRIX_SIZE    ((OLED_DISPLAY_HEIGHT / 8) * OLED_DISPLAY_WIDTH)
 
 typedef struct {
     uint8_t col;
@@ -46,19 +50,70 @@ typedef enum {
     OLED_ROTATION_270 = 3, // OLED_ROTATION_90 | OLED_ROTATION_180
 } oled_rotation_t;
 
-void init(void);
-void destroy(void);
-
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
+void oled_write_raw_byte(const char data, uint16_t index);
+
+/* where reading the display buffer from start_index starts, and how far it goes */
+typedef struct __attribute__((__packed__)) {
+    uint8_t *current_element;
+    uint16_t remaining_element_count;
+} oled_buffer_reader_t;
+
+oled_buffer_reader_t oled_read_raw(uint16_t start_index);
 
 void oled_clear(void);
+void oled_render(void);
+
+oled_rotation_t oled_init_user(oled_rotation_t rotation);
+bool oled_task_user(void);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
 
 uint16_t timer_read(void);
 uint16_t timer_elapsed(uint16_t last);
 
-static inline bool is_keyboard_master(void)
-{
-    return true;
-}
+bool is_keyboard_master(void);
+
+/* layers, mods and leds as the firmware reads them, set by the frontends */
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+
+uint8_t get_highest_layer(layer_state_t state);
+
+#define MOD_MASK_CTRL  0x11
+#define MOD_MASK_SHIFT 0x22
+#define MOD_MASK_ALT   0x44
+#define MOD_MASK_GUI   0x88
+
+uint8_t get_mods(void);
+
+typedef struct {
+    bool num_lock : 1;
+    bool caps_lock : 1;
+    bool scroll_lock : 1;
+    bool compose : 1;
+    bool kana : 1;
+} led_t;
+
+led_t host_keyboard_led_state(void);
+
+void keyboard_post_init_user(void);
+void housekeeping_task_user(void);
+
+/* split transactions, user ids come from SPLIT_TRANSACTION_IDS_USER like in qmk */
+enum serial_transaction_id {
+#ifdef SPLIT_TRANSACTION_IDS_USER
+    SPLIT_TRANSACTION_IDS_USER,
+#endif
+    NUM_TRANSACTIONS,
+};
+
+#define RPC_M2S_BUFFER_SIZE 32
+#define RPC_S2M_BUFFER_SIZE 32
+
+typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer);
 
 #endif // oled_h_INCLUDED
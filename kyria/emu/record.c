@@ -0,0 +1,504 @@
+#include <err.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "record.h"
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+/* gif codes are up to 12 bits */
+#define LZW_CODES 4096
+/* 1 bit pixels, but gif's lzw starts from at least 2 bit codes */
+#define LZW_MIN 2
+#define LZW_CLEAR (1 << LZW_MIN)
+#define LZW_END (LZW_CLEAR + 1)
+
+/* the two colors, off and on like the sdl frontend */
+static const uint8_t palette[2][3] = {
+    { 0x00, 0x00, 0x00 },
+    { 0xd6, 0xf4, 0xff },
+};
+
+typedef struct slot slot_t;
+
+struct slot {
+    uint32_t ms;
+    uint8_t frame[OLED_MATRIX_SIZE];
+};
+
+typedef struct gif gif_t;
+
+struct gif {
+    FILE *f;
+    /* what the viewer shows after the last image written */
+    uint8_t shown[OLED_MATRIX_SIZE];
+    /* the next image, written once it's known how long it shows */
+    uint8_t pending[OLED_MATRIX_SIZE];
+    uint32_t pending_ms;
+    bool has_pending;
+    uint32_t images;
+
+    /* lzw string table, the code for a code's string and one more pixel */
+    uint16_t next[LZW_CODES][2];
+    uint16_t codes;
+    uint8_t width;
+
+    /* bits not yet a byte, and bytes not yet a sub-block */
+    uint32_t bits;
+    uint8_t nbits;
+    uint8_t block[255];
+    uint8_t len;
+};
+
+struct record {
+    const char *dir;
+    gif_t *gif;
+    bool block;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    /* signalled when a frame is queued or closing is set, and when a slot frees */
+    pthread_cond_t ready;
+    pthread_cond_t room;
+
+    /* frames queued oldest first from head, wrapping around */
+    slot_t *queue;
+    size_t head;
+    size_t len;
+    bool closing;
+    uint32_t end;
+
+    uint32_t recorded;
+    uint32_t dropped;
+    size_t deepest;
+};
+
+static inline bool lit(const uint8_t *frame, int x, int y)
+{
+    return frame[(y / 8) * OLED_DISPLAY_WIDTH + x] & (1 << (y % 8));
+}
+
+/*
+ * binary pbm, rows of 128 pixels msb first, set bits are lit pixels
+ */
+static void writepbm(const char *dir, uint32_t ms, const uint8_t *frame)
+{
+    char path[4096];
+    uint8_t row[OLED_DISPLAY_WIDTH / 8];
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%s/%08" PRIu32 ".pbm", dir, ms);
+
+    f = fopen(path, "wb");
+    if (!f) {
+        err(1, "%s", path);
+    }
+
+    fprintf(f, "P4\n%d %d\n", OLED_DISPLAY_WIDTH, OLED_DISPLAY_HEIGHT);
+    for (int y = 0; y < OLED_DISPLAY_HEIGHT; y++) {
+        memset(row, 0, sizeof(row));
+
+        for (int x = 0; x < OLED_DISPLAY_WIDTH; x++) {
+            if (lit(frame, x, y)) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+
+        fwrite(row, sizeof(row), 1, f);
+    }
+
+    if (fclose(f) == EOF) {
+        err(1, "%s", path);
+    }
+}
+
+static void put16(FILE *f, uint16_t v)
+{
+    fputc(v & 0xff, f);
+    fputc(v >> 8, f);
+}
+
+/*
+ * the header, a 2 color palette and the netscape extension that makes
+ * the animation loop
+ */
+static void gifstart(gif_t *g)
+{
+    fputs("GIF89a", g->f);
+    put16(g->f, OLED_DISPLAY_WIDTH);
+    put16(g->f, OLED_DISPLAY_HEIGHT);
+    /* a global palette of 2 colors, background 0 */
+    fputc(0x80, g->f);
+    fputc(0, g->f);
+    fputc(0, g->f);
+    fwrite(palette, sizeof(palette), 1, g->f);
+
+    fputc(0x21, g->f);
+    fputc(0xff, g->f);
+    fputc(11, g->f);
+    fputs("NETSCAPE2.0", g->f);
+    fputc(3, g->f);
+    fputc(1, g->f);
+    put16(g->f, 0);
+    fputc(0, g->f);
+}
+
+static void flushblock(gif_t *g)
+{
+    if (g->len) {
+        fputc(g->len, g->f);
+        fwrite(g->block, g->len, 1, g->f);
+        g->len = 0;
+    }
+}
+
+/* codes are packed lsb first, in sub-blocks of up to 255 bytes */
+static void emit(gif_t *g, uint16_t code)
+{
+    g->bits |= (uint32_t)code << g->nbits;
+    g->nbits += g->width;
+
+    while (g->nbits >= 8) {
+        g->block[g->len++] = g->bits & 0xff;
+        g->bits >>= 8;
+        g->nbits -= 8;
+
+        if (g->len == sizeof(g->block)) {
+            flushblock(g);
+        }
+    }
+}
+
+static void lzwreset(gif_t *g)
+{
+    memset(g->next, 0, sizeof(g->next));
+    g->codes = LZW_END + 1;
+    g->width = LZW_MIN + 1;
+}
+
+/*
+ * the pixels of a rectangle of the frame, row by row, as lzw codes.
+ * 0 in next is no entry, no string's code is ever 0 as 0 is a pixel.
+ */
+static void lzw(gif_t *g, const uint8_t *frame, int x0, int y0, int w, int h)
+{
+    uint16_t prefix;
+    uint8_t pixel;
+    bool first;
+
+    lzwreset(g);
+    g->bits = 0;
+    g->nbits = 0;
+    g->len = 0;
+
+    emit(g, LZW_CLEAR);
+
+    prefix = 0;
+    first = true;
+    for (int y = y0; y < y0 + h; y++) {
+        for (int x = x0; x < x0 + w; x++) {
+            pixel = lit(frame, x, y);
+
+            if (first) {
+                prefix = pixel;
+                first = false;
+                continue;
+            }
+
+            if (g->next[prefix][pixel]) {
+                prefix = g->next[prefix][pixel];
+                continue;
+            }
+
+            emit(g, prefix);
+
+            if (g->codes < LZW_CODES) {
+                /* the decoder widens its codes a code later than it could */
+                if (g->codes == 1 << g->width) {
+                    g->width++;
+                }
+                g->next[prefix][pixel] = g->codes++;
+            } else {
+                emit(g, LZW_CLEAR);
+                lzwreset(g);
+            }
+
+            prefix = pixel;
+        }
+    }
+
+    emit(g, prefix);
+    emit(g, LZW_END);
+
+    if (g->nbits) {
+        g->block[g->len++] = g->bits & 0xff;
+        if (g->len == sizeof(g->block)) {
+            flushblock(g);
+        }
+    }
+    flushblock(g);
+    fputc(0, g->f);
+}
+
+/*
+ * write the pending frame, shown for cs hundredths of a second. only
+ * the rectangle that changed since the last one is written, over it.
+ */
+static void gifimage(gif_t *g, uint16_t cs)
+{
+    int x0, y0, x1, y1;
+
+    x0 = OLED_DISPLAY_WIDTH;
+    y0 = OLED_DISPLAY_HEIGHT;
+    x1 = 0;
+    y1 = 0;
+
+    for (int y = 0; y < OLED_DISPLAY_HEIGHT; y++) {
+        for (int x = 0; x < OLED_DISPLAY_WIDTH; x++) {
+            if (g->images && lit(g->pending, x, y) == lit(g->shown, x, y)) {
+                continue;
+            }
+
+            if (x < x0) {
+                x0 = x;
+            }
+            if (y < y0) {
+                y0 = y;
+            }
+            if (x >= x1) {
+                x1 = x + 1;
+            }
+            if (y >= y1) {
+                y1 = y + 1;
+            }
+        }
+    }
+
+    /* nothing changed, a pixel still has to carry the delay */
+    if (x0 >= x1) {
+        x0 = y0 = 0;
+        x1 = y1 = 1;
+    }
+
+    /* graphic control: keep the image when the next is drawn over it */
+    fputc(0x21, g->f);
+    fputc(0xf9, g->f);
+    fputc(4, g->f);
+    fputc(1 << 2, g->f);
+    put16(g->f, cs);
+    fputc(0, g->f);
+    fputc(0, g->f);
+
+    fputc(0x2c, g->f);
+    put16(g->f, x0);
+    put16(g->f, y0);
+    put16(g->f, x1 - x0);
+    put16(g->f, y1 - y0);
+    fputc(0, g->f);
+
+    fputc(LZW_MIN, g->f);
+    lzw(g, g->pending, x0, y0, x1 - x0, y1 - y0);
+
+    memcpy(g->shown, g->pending, sizeof(g->shown));
+    g->images++;
+}
+
+/*
+ * a frame's delay is only known when the next one comes. frames less
+ * than a hundredth of a second apart, gif's resolution, are merged into
+ * the first one's slot.
+ */
+static void gifframe(gif_t *g, uint32_t ms, const uint8_t *frame)
+{
+    uint32_t cs;
+
+    if (g->has_pending) {
+        cs = ms / 10 - g->pending_ms / 10;
+        if (!cs) {
+            memcpy(g->pending, frame, sizeof(g->pending));
+            return;
+        }
+
+        gifimage(g, MIN(cs, UINT16_MAX));
+    }
+
+    memcpy(g->pending, frame, sizeof(g->pending));
+    g->pending_ms = ms;
+    g->has_pending = true;
+}
+
+static void gifend(gif_t *g, uint32_t ms)
+{
+    uint32_t cs;
+
+    if (g->has_pending) {
+        cs = ms > g->pending_ms ? ms / 10 - g->pending_ms / 10 : 0;
+        gifimage(g, MIN(MAX(cs, 1), UINT16_MAX));
+    }
+
+    fputc(0x3b, g->f);
+}
+
+static void *writer(void *arg)
+{
+    record_t *r = arg;
+    slot_t *s;
+
+    for (;;) {
+        pthread_mutex_lock(&r->lock);
+        while (!r->len && !r->closing) {
+            pthread_cond_wait(&r->ready, &r->lock);
+        }
+        if (!r->len) {
+            pthread_mutex_unlock(&r->lock);
+            break;
+        }
+        /* the slot at head is left alone until head moves past it */
+        s = &r->queue[r->head];
+        pthread_mutex_unlock(&r->lock);
+
+        if (r->gif) {
+            gifframe(r->gif, s->ms, s->frame);
+        } else {
+            writepbm(r->dir, s->ms, s->frame);
+        }
+
+        pthread_mutex_lock(&r->lock);
+        r->head = (r->head + 1) % RECORD_QUEUE;
+        r->len--;
+        pthread_cond_signal(&r->room);
+        pthread_mutex_unlock(&r->lock);
+    }
+
+    if (r->gif) {
+        gifend(r->gif, r->end);
+    }
+
+    return NULL;
+}
+
+static bool isgif(const char *path)
+{
+    size_t len;
+
+    len = strlen(path);
+
+    return len >= 4 && strcmp(path + len - 4, ".gif") == 0;
+}
+
+record_t *record_open(const char *path, bool block)
+{
+    record_t *r;
+
+    r = calloc(1, sizeof(*r));
+    if (!r) {
+        err(1, "calloc");
+    }
+
+    r->queue = calloc(RECORD_QUEUE, sizeof(*r->queue));
+    if (!r->queue) {
+        err(1, "calloc");
+    }
+
+    r->block = block;
+
+    if (isgif(path)) {
+        r->gif = calloc(1, sizeof(*r->gif));
+        if (!r->gif) {
+            err(1, "calloc");
+        }
+
+        r->gif->f = fopen(path, "wb");
+        if (!r->gif->f) {
+            err(1, "%s", path);
+        }
+
+        gifstart(r->gif);
+    } else {
+        r->dir = path;
+    }
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->ready, NULL);
+    pthread_cond_init(&r->room, NULL);
+
+    if ((errno = pthread_create(&r->thread, NULL, writer, r))) {
+        err(1, "pthread_create");
+    }
+
+    return r;
+}
+
+bool record_frame(record_t *r, uint32_t ms, const uint8_t *frame)
+{
+    slot_t *s;
+
+    pthread_mutex_lock(&r->lock);
+
+    while (r->len == RECORD_QUEUE && r->block) {
+        pthread_cond_wait(&r->room, &r->lock);
+    }
+
+    if (r->len == RECORD_QUEUE) {
+        r->dropped++;
+        pthread_mutex_unlock(&r->lock);
+        return false;
+    }
+
+    s = &r->queue[(r->head + r->len) % RECORD_QUEUE];
+    s->ms = ms;
+    memcpy(s->frame, frame, sizeof(s->frame));
+
+    r->len++;
+    r->recorded++;
+    if (r->len > r->deepest) {
+        r->deepest = r->len;
+    }
+
+    pthread_cond_signal(&r->ready);
+    pthread_mutex_unlock(&r->lock);
+
+    return true;
+}
+
+void record_close(record_t *r, uint32_t ms)
+{
+    pthread_mutex_lock(&r->lock);
+    r->closing = true;
+    r->end = ms;
+    pthread_cond_signal(&r->ready);
+    pthread_mutex_unlock(&r->lock);
+
+    if ((errno = pthread_join(r->thread, NULL))) {
+        err(1, "pthread_join");
+    }
+
+    fprintf(stderr, "record: %" PRIu32 " frames, %" PRIu32 " dropped, at most %zu of %d queued",
+        r->recorded, r->dropped, r->deepest, RECORD_QUEUE);
+
+    if (r->gif) {
+        fprintf(stderr, ", %" PRIu32 " gif images\n", r->gif->images);
+
+        if (fclose(r->gif->f) == EOF) {
+            err(1, "fclose");
+        }
+        free(r->gif);
+    } else {
+        fputc('\n', stderr);
+    }
+
+    pthread_cond_destroy(&r->room);
+    pthread_cond_destroy(&r->ready);
+    pthread_mutex_destroy(&r->lock);
+    free(r->queue);
+    free(r);
+}
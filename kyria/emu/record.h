@@ -0,0 +1,34 @@
+#ifndef record_h_INCLUDED
+#define record_h_INCLUDED
+
+#include "qmk.h"
+
+/*
+ * frame recording for the frontends. a frame handed to record_frame is
+ * copied into a queue, and a thread of its own encodes and writes it,
+ * so recording costs the loop drawing the frames a 1KB copy. a path
+ * ending in .gif gets an animated gif, timed by the frames' ms, any
+ * other path is a directory that gets a binary pbm per frame, named
+ * <ms>.pbm.
+ */
+
+/* frames the queue holds before the writer has to catch up */
+#define RECORD_QUEUE 256
+
+typedef struct record record_t;
+
+/*
+ * start recording to path, exits on any error. when the writer falls
+ * behind, record_frame waits for it if block is set, and drops the
+ * frame otherwise.
+ */
+record_t *record_open(const char *path, bool block);
+/* record a frame, OLED_MATRIX_SIZE bytes in page order, shown at ms */
+bool record_frame(record_t *r, uint32_t ms, const uint8_t *frame);
+/*
+ * write what is queued, the last frame shown until ms, and report the
+ * frames written and dropped on stderr
+ */
+void record_close(record_t *r, uint32_t ms);
+
+#endif // record_h_INCLUDED
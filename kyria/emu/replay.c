@@ -0,0 +1,194 @@
+/*
+ * headless, deterministic replay of a key event trace.
+ *
+ * time is simulated in 1 ms ticks from the trace's 0, so the same trace
+ * always renders the same frames. for every frame the display changed,
+ * one line is printed:
+ *
+ *     <ms> <fnv-1a hash of the frame> <i2c bytes for the frame>
+ *
+ * the ripple stats go to stderr every RIPPLE_STATS_INTERVAL, like the
+ * keyboard's console, and once more at the end.
+ *
+ * usage: replay [-g golden] [-p path] [-r render] [-t tail ms] [-z ms] trace
+ *
+ *   -g  compare against a previous run's output, fail on the first
+ *       frame that differs
+ *   -p  also record each frame, to path/<ms>.pbm or to an animated gif
+ *       when path ends in .gif, see record.h
+ *   -r  ring rasterizer: pixel, bytes or atlas
+ *   -t  keep running this long after the last event (default 6000)
+ *   -z  have timer_read at this ms at the trace's 0, so it wraps within
+ *       the run. the ripples are seeded as they would be at 0, and the
+ *       frames must come out the same as without it
+ *
+ * see trace.h for the trace format.
+ */
+#include <err.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "emu.h"
+#include "record.h"
+#include "trace.h"
+#include "../comp.h"
+#include "../ripple.h"
+
+static void usage(const char *argv0)
+{
+    errx(1, "usage: %s [-g golden] [-p path] [-r render] [-t tail ms] [-z ms] trace", argv0);
+}
+
+static uint8_t parserender(const char *name)
+{
+    for (uint8_t i = 0; i < RIPPLE_RENDER_COUNT; i++) {
+        if (strcmp(name, ripple_render_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    errx(1, "unknown render %s", name);
+}
+
+int main(int argc, char **argv)
+{
+    trace_t trace = {0};
+    keyrecord_t r;
+    FILE *golden;
+    record_t *rec;
+    char line[128];
+    char expect[128];
+    uint32_t tail;
+    uint32_t zero;
+    uint32_t end;
+    uint32_t frames;
+    uint64_t start;
+    uint64_t ns;
+    size_t next;
+    int opt;
+
+    golden = NULL;
+    rec = NULL;
+    tail = 6000;
+    zero = 0;
+
+    while ((opt = getopt(argc, argv, "g:p:r:t:z:")) != -1) {
+        switch (opt) {
+            case 'g':
+                golden = fopen(optarg, "r");
+                if (!golden) {
+                    err(1, "%s", optarg);
+                }
+                break;
+            case 'p':
+                /* headless, so wait for the writer rather than drop frames */
+                rec = record_open(optarg, true);
+                break;
+            case 'r':
+                ripple_render = parserender(optarg);
+                break;
+            case 't':
+                tail = strtoul(optarg, NULL, 10);
+                break;
+            case 'z':
+                zero = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (optind != argc - 1) {
+        usage(argv[0]);
+    }
+
+    trace_read(&trace, argv[optind]);
+    end = trace_end(&trace) + tail;
+
+    emu_timer_set(zero);
+    keyboard_post_init_user();
+    oled_init_user(OLED_ROTATION_0);
+
+    /* as ripple_ctx_init would seed it at the trace's 0 */
+    ripple_ctx_seed(ripple_ctx(), 0);
+
+    ns = 0;
+    next = 0;
+    frames = 0;
+    for (uint32_t ms = 0; ms <= end; ms++) {
+        emu_timer_set(zero + ms);
+
+        for (; next < trace.len && trace.events[next].ms <= ms; next++) {
+            r = trace_record(&trace.events[next]);
+            process_record_user(0, &r);
+        }
+
+        /* no slave, its transactions go nowhere */
+        housekeeping_task_user();
+
+        start = emu_now();
+        oled_task_user();
+        ns += emu_now() - start;
+
+        if (!emu_dirty()) {
+            continue;
+        }
+
+        oled_render();
+        frames++;
+
+        snprintf(line, sizeof(line), "%" PRIu32 " %016" PRIx64 " %" PRIu32 "\n",
+            ms,
+            emu_frame_hash(),
+            emu_bus_bytes());
+        fputs(line, stdout);
+
+        if (rec) {
+            record_frame(rec, ms, emu_framebuffer());
+        }
+
+        if (golden) {
+            if (!fgets(expect, sizeof(expect), golden)) {
+                errx(1, "frame at %" PRIu32 " ms is not in the golden run", ms);
+            }
+
+            if (strcmp(line, expect) != 0) {
+                errx(1, "frame at %" PRIu32 " ms differs, expected %s", ms, expect);
+            }
+        }
+    }
+
+    if (golden) {
+        if (fgets(expect, sizeof(expect), golden)) {
+            errx(1, "golden run has more frames, next is %s", expect);
+        }
+
+        fclose(golden);
+    }
+
+    if (rec) {
+        record_close(rec, end);
+    }
+
+    fprintf(stderr, "%" PRIu32 " frames, %" PRIu64 " ns in oled_task_user\n",
+        frames, ns);
+
+    for (comp_layer_t *l = comp_layers(); l; l = l->next) {
+        fprintf(stderr, "  layer %s: %" PRIu32 " updates, %" PRIu64 " ns updating, %" PRIu32 " bytes blended in %" PRIu64 " ns\n",
+            l->name,
+            l->stats.updates,
+            l->stats.update_ns,
+            l->stats.blended,
+            l->stats.blend_ns);
+    }
+
+    ripple_stats_report(ripple_ctx());
+
+    trace_free(&trace);
+
+    return 0;
+}
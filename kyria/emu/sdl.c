@@ -0,0 +1,437 @@
+/*
+ * sdl frontend, shows the display in a window and turns key presses
+ * into random key events. the host's mods and lock keys are the
+ * keyboard's, and F1 to F4 hold layers 0 to 3, for the status widgets.
+ *
+ * the loop sleeps until the next tick or input event, whichever comes
+ * first, and calls oled_task_user once per tick like the firmware's
+ * main loop would. the window title shows the bus bytes and time per
+ * frame, the cpu use and wakeups per second of the emulator itself,
+ * the us per second each compositor layer spent updating and blending,
+ * and the ripple engine's frames, live ripples, bresenham steps and
+ * clipped pixels per frame.
+ *
+ * usage: oled [-c clock] [-o path] [-s scale] [-t tick ms]
+ *
+ *   -c  timer_read's clock: real (the default), warp:<n> for n times
+ *       as fast, or step:<ms> to move ms on every tick whatever the
+ *       host time. any of them can start at a given ms, as in
+ *       warp:10@60000 to wrap timer_read 5 s in. see emu.h
+ *   -o  record every frame shown, to path/<ms>.pbm or to an animated
+ *       gif when path ends in .gif, see record.h. frames the writer
+ *       can't keep up with are dropped rather than hold up the loop
+ *   -s  show every pixel as a square this many pixels wide (default 4),
+ *       the window only resizes to whole multiples
+ *   -t  ms between oled_task_user calls (default 10)
+ */
+#include <err.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include <SDL2/SDL.h>
+
+#include "emu.h"
+#include "record.h"
+#include "../comp.h"
+#include "../ripple.h"
+
+typedef struct bus bus_t;
+
+struct bus {
+    /* bytes and frames since the last report */
+    uint32_t bytes;
+    uint32_t frames;
+    /* time spent in oled_task_user for those frames */
+    uint64_t ns;
+    uint16_t reported;
+};
+
+static bus_t bus;
+
+typedef struct load load_t;
+
+/* what the emulator costs the host, for checking that idle is idle */
+struct load {
+    /* returns from waiting since the last report */
+    uint32_t wakeups;
+    /* process cpu time and host time at the last report, in ns */
+    uint64_t cpu;
+    uint64_t wall;
+};
+
+static load_t load;
+
+#define TICK_DEFAULT 10
+#define SCALE_DEFAULT 4
+
+static inline uint32_t color(bool on)
+{
+    if (on) {
+        return 0xffd6f4ff;
+    } else {
+        return 0xff000000;
+    }
+}
+
+const int SCREEN_WIDTH = 128;
+const int SCREEN_HEIGHT = 64;
+
+static SDL_Window *win;
+static SDL_Renderer *ren = NULL;
+static SDL_Texture *tex = NULL;
+
+/* where frames are recorded, or NULL, and host time at the start in ns */
+static record_t *rec = NULL;
+static uint64_t epoch;
+
+static void init(int scale)
+{
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        err(1, "failed to initialize sdl");
+    }
+
+    win = SDL_CreateWindow(
+        "OLED",
+        SDL_WINDOWPOS_UNDEFINED,
+        SDL_WINDOWPOS_UNDEFINED,
+        SCREEN_WIDTH * scale,
+        SCREEN_HEIGHT * scale,
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+
+    if (!win) {
+        err(1, "failed to create window");
+    }
+
+    /* blocky pixels, scaled by whole multiples of the display */
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+
+    ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
+    if (!ren) {
+        err(1, "failed to create renderer");
+    }
+
+    if (SDL_RenderSetLogicalSize(ren, SCREEN_WIDTH, SCREEN_HEIGHT) < 0
+        || SDL_RenderSetIntegerScale(ren, SDL_TRUE) < 0) {
+        err(1, "failed to scale renderer");
+    }
+
+    tex = SDL_CreateTexture(
+        ren,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        SCREEN_WIDTH,
+        SCREEN_HEIGHT);
+
+    if (!tex) {
+        err(1, "failed to create texture");
+    }
+}
+
+static void destroy(void)
+{
+    SDL_DestroyTexture(tex);
+    SDL_DestroyRenderer(ren);
+    SDL_DestroyWindow(win);
+    SDL_Quit();
+}
+
+static uint64_t cputime(void)
+{
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_SELF, &ru) == -1) {
+        err(1, "getrusage");
+    }
+
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * UINT64_C(1000000000)
+        + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * UINT64_C(1000);
+}
+
+/*
+ * once a second of the firmware's clock, show the average bus bytes per
+ * frame and the host load in the title
+ */
+static void report(void)
+{
+    char title[320];
+    ripple_stats_t *s;
+    uint32_t frames;
+    uint64_t cpu;
+    uint64_t wall;
+    int len;
+
+    if (timer_elapsed(bus.reported) < 1000) {
+        return;
+    }
+
+    cpu = cputime();
+    wall = emu_now();
+
+    len = snprintf(title, sizeof(title), "OLED - %lu B/frame %lu us/frame, %lu%% cpu %lu wakeups/s",
+        (unsigned long)(bus.frames ? bus.bytes / bus.frames : 0),
+        (unsigned long)(bus.frames ? bus.ns / bus.frames / 1000 : 0),
+        (unsigned long)((cpu - load.cpu) * 100 / (wall - load.wall)),
+        (unsigned long)(load.wakeups * UINT64_C(1000000000) / (wall - load.wall)));
+
+    for (comp_layer_t *l = comp_layers(); l; l = l->next) {
+        if (len < 0 || (size_t)len >= sizeof(title)) {
+            break;
+        }
+
+        len += snprintf(title + len, sizeof(title) - len, ", %s %lu+%lu us",
+            l->name,
+            (unsigned long)(l->stats.update_ns / 1000),
+            (unsigned long)(l->stats.blend_ns / 1000));
+
+        l->stats = (comp_stats_t){0};
+    }
+
+    s = &ripple_ctx()->stats;
+    frames = s->frames ? s->frames : 1;
+
+    if (len >= 0 && (size_t)len < sizeof(title)) {
+        snprintf(title + len, sizeof(title) - len, ", ripples %lu fps %lu alive %lu steps %lu clipped %lu us",
+            (unsigned long)s->frames,
+            (unsigned long)(s->alive / frames),
+            (unsigned long)(s->steps / frames),
+            (unsigned long)(s->clipped / frames),
+            (unsigned long)(s->frame_us / frames));
+    }
+
+    *s = (ripple_stats_t){0};
+
+    SDL_SetWindowTitle(win, title);
+
+    bus.bytes = 0;
+    bus.frames = 0;
+    bus.ns = 0;
+    bus.reported = timer_read();
+
+    load.wakeups = 0;
+    load.cpu = cpu;
+    load.wall = wall;
+}
+
+/*
+ * expand the page buffer into the texture and present it,
+ * one upload and one copy per frame
+ */
+static void flush(void)
+{
+    uint8_t *pixels;
+    uint32_t *row;
+    const uint8_t *page;
+    int pitch;
+
+    if (SDL_LockTexture(tex, NULL, (void **)&pixels, &pitch) < 0) {
+        err(1, "failed to lock texture");
+    }
+
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        row = (uint32_t *)(pixels + y * pitch);
+        page = &emu_framebuffer()[(y / 8) * SCREEN_WIDTH];
+
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            row[x] = color((page[x] >> (y % 8)) & 1);
+        }
+    }
+
+    SDL_UnlockTexture(tex);
+
+    SDL_RenderClear(ren);
+    SDL_RenderCopy(ren, tex, NULL, NULL);
+    SDL_RenderPresent(ren);
+}
+
+/*
+ * show a new frame, and hand it to the recorder
+ */
+static void show(void)
+{
+    flush();
+
+    if (rec) {
+        record_frame(rec, (emu_now() - epoch) / 1000000, emu_framebuffer());
+    }
+}
+
+/* hand the host's mods and locks, and the layer held, to the firmware */
+static void status(const SDL_KeyboardEvent *key)
+{
+    SDL_Keymod m;
+    led_t leds = {0};
+
+    m = SDL_GetModState();
+    emu_set_mods((m & KMOD_LCTRL ? 0x01 : 0)
+        | (m & KMOD_LSHIFT ? 0x02 : 0)
+        | (m & KMOD_LALT ? 0x04 : 0)
+        | (m & KMOD_LGUI ? 0x08 : 0)
+        | (m & KMOD_RCTRL ? 0x10 : 0)
+        | (m & KMOD_RSHIFT ? 0x20 : 0)
+        | (m & KMOD_RALT ? 0x40 : 0)
+        | (m & KMOD_RGUI ? 0x80 : 0));
+
+    leds.caps_lock = (m & KMOD_CAPS) != 0;
+    leds.num_lock = (m & KMOD_NUM) != 0;
+    emu_set_leds(leds);
+
+    if (key->keysym.sym >= SDLK_F1 && key->keysym.sym <= SDLK_F4) {
+        layer_state = key->type == SDL_KEYDOWN ? (layer_state_t)1 << (key->keysym.sym - SDLK_F1) : 0;
+    }
+}
+
+/*
+ * returns true when the event asks to quit
+ */
+static bool handle(const SDL_Event *ev)
+{
+    keyrecord_t r;
+
+    if (ev->type == SDL_QUIT) {
+        return true;
+    }
+
+    /* the window was resized or uncovered, draw the frame again */
+    if (ev->type == SDL_WINDOWEVENT && ev->window.event == SDL_WINDOWEVENT_EXPOSED) {
+        flush();
+        return false;
+    }
+
+    if (ev->type != SDL_KEYDOWN && ev->type != SDL_KEYUP) {
+        return false;
+    }
+
+    status(&ev->key);
+
+    memset(&r, 0, sizeof(r));
+    r.event.key.col = rand() % MATRIX_COLS;
+    r.event.key.row = rand() % MATRIX_ROWS;
+    r.event.pressed = ev->type == SDL_KEYDOWN;
+    r.keycode = ev->key.keysym.sym;
+
+    process_record_user(ev->key.keysym.sym, &r);
+
+    return ev->key.keysym.sym == SDLK_q;
+}
+
+static void tick(void)
+{
+    uint64_t start;
+
+    emu_tick();
+
+    /* a single half, there is no slave to send to */
+    housekeeping_task_user();
+
+    start = emu_now();
+    oled_task_user();
+    if (emu_dirty()) {
+        bus.ns += emu_now() - start;
+        oled_render();
+        bus.bytes += emu_bus_bytes();
+        bus.frames++;
+        show();
+    }
+
+    report();
+}
+
+int main(int argc, char **argv)
+{
+    SDL_Event ev;
+    uint64_t interval;
+    uint64_t deadline;
+    uint64_t now;
+    const char *path;
+    bool quit;
+    int scale;
+    int wait;
+    int opt;
+
+    interval = TICK_DEFAULT * UINT64_C(1000000);
+    scale = SCALE_DEFAULT;
+    path = NULL;
+
+    while ((opt = getopt(argc, argv, "c:o:s:t:")) != -1) {
+        switch (opt) {
+            case 'c':
+                if (!emu_parse_clock(optarg)) {
+                    errx(1, "clock must be real, warp:<n> or step:<ms>, with an optional @<start ms>");
+                }
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            case 's':
+                scale = atoi(optarg);
+                break;
+            case 't':
+                interval = strtoul(optarg, NULL, 10) * UINT64_C(1000000);
+                break;
+            default:
+                errx(1, "usage: %s [-c clock] [-o path] [-s scale] [-t tick ms]", argv[0]);
+        }
+    }
+
+    if (!interval) {
+        errx(1, "tick must be at least 1 ms");
+    }
+    if (scale < 1) {
+        errx(1, "scale must be at least 1");
+    }
+
+    /* the title shows the ripple stats, not the console */
+    ripple_stats_interval = 0;
+
+    init(scale);
+
+    epoch = emu_now();
+    if (path) {
+        rec = record_open(path, false);
+    }
+
+    keyboard_post_init_user();
+    oled_init_user(OLED_ROTATION_0);
+    oled_task_user();
+    oled_render();
+    show();
+
+    bus.reported = timer_read();
+    load.cpu = cputime();
+    load.wall = emu_now();
+
+    deadline = emu_now();
+    quit = false;
+    while (!quit) {
+        now = emu_now();
+        if (now >= deadline) {
+            tick();
+
+            /* after a stall, start afresh rather than tick to catch up */
+            deadline += interval;
+            if (deadline <= now) {
+                deadline = now + interval;
+            }
+        }
+
+        now = emu_now();
+        wait = deadline > now ? (deadline - now + 999999) / 1000000 : 0;
+
+        if (SDL_WaitEventTimeout(&ev, wait)) {
+            quit = handle(&ev);
+            while (!quit && SDL_PollEvent(&ev)) {
+                quit = handle(&ev);
+            }
+        }
+        load.wakeups++;
+    }
+
+    if (rec) {
+        record_close(rec, (emu_now() - epoch) / 1000000);
+    }
+
+    destroy();
+}
@@ -0,0 +1,233 @@
+/*
+ * headless soak test of independent ripple engines.
+ *
+ * every engine is a ripple_ctx_t with its own simulated clock, stepped
+ * a ms at a time and fed presses at random from a generator seeded by
+ * its index, so each engine plays the same run however the engines are
+ * spread over the threads. every frame an engine draws is hashed into
+ * its checksum. at the end the throughput is reported with a checksum
+ * over all the engines, which must not change with -j.
+ *
+ * usage: ripplesoak [-j threads] [-n engines] [-p presses/s] [-r render] [-s seconds]
+ *
+ *   -j  threads to spread the engines over (default 1)
+ *   -n  engines (default 64)
+ *   -p  average presses per second per engine (default 8)
+ *   -r  rasterizer: pixel, bytes or atlas
+ *   -s  simulated seconds each engine runs (default 60)
+ */
+#include <err.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "emu.h"
+#include "../ripple.h"
+
+typedef struct engine engine_t;
+
+struct engine {
+    /* first, so the clock can find its engine */
+    ripple_ctx_t ctx;
+    /* simulated ms, timer_read is its low 16 bits */
+    uint32_t ms;
+    /* xorshift32 state for the presses */
+    uint32_t state;
+    uint64_t hash;
+    uint32_t frames;
+    uint32_t presses;
+    /* what ctx draws into, there is only the one display */
+    uint8_t frame[OLED_MATRIX_SIZE];
+};
+
+typedef struct worker worker_t;
+
+struct worker {
+    pthread_t thread;
+    engine_t *engines;
+    size_t first;
+    size_t count;
+};
+
+static uint32_t duration;
+static uint32_t rate;
+
+static uint16_t engine_clock(ripple_ctx_t *c)
+{
+    return ((engine_t *)c)->ms;
+}
+
+static uint32_t next(engine_t *e)
+{
+    e->state ^= e->state << 13;
+    e->state ^= e->state >> 17;
+    e->state ^= e->state << 5;
+
+    return e->state;
+}
+
+/* fnv-1a, continued from h */
+static uint64_t fnv(uint64_t h, const uint8_t *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+static void run(engine_t *e, uint32_t index)
+{
+    uint32_t r;
+    uint16_t last;
+
+    e->ms = index * 977;
+    e->state = index * 2654435761u + 1;
+    e->hash = 0xcbf29ce484222325ULL;
+    e->ctx.frame = e->frame;
+    ripple_ctx_init(&e->ctx, engine_clock);
+
+    for (uint32_t t = 0; t < duration; t++, e->ms++) {
+        r = next(e);
+        if (r % 1000 < rate) {
+            ripple_ctx_add(&e->ctx, (r >> 10) % OLED_DISPLAY_WIDTH, (r >> 20) % OLED_DISPLAY_HEIGHT);
+            e->presses++;
+        }
+
+        last = e->ctx.sched.last;
+        ripple_ctx_render(&e->ctx);
+
+        if (e->ctx.sched.last != last) {
+            e->hash = fnv(e->hash, e->frame, sizeof(e->frame));
+            e->frames++;
+        }
+    }
+}
+
+static void *work(void *arg)
+{
+    worker_t *w = arg;
+
+    for (size_t i = w->first; i < w->first + w->count; i++) {
+        run(&w->engines[i], i);
+    }
+
+    return NULL;
+}
+
+static uint8_t parserender(const char *name)
+{
+    for (uint8_t i = 0; i < RIPPLE_RENDER_COUNT; i++) {
+        if (strcmp(name, ripple_render_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    errx(1, "unknown render %s", name);
+}
+
+int main(int argc, char **argv)
+{
+    engine_t *engines;
+    worker_t *workers;
+    uint64_t checksum;
+    uint64_t frames;
+    uint64_t presses;
+    uint64_t start;
+    double secs;
+    size_t threads;
+    size_t count;
+    size_t first;
+    int opt;
+
+    threads = 1;
+    count = 64;
+    rate = 8;
+    duration = 60;
+
+    while ((opt = getopt(argc, argv, "j:n:p:r:s:")) != -1) {
+        switch (opt) {
+            case 'j':
+                threads = strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                count = strtoul(optarg, NULL, 10);
+                break;
+            case 'p':
+                rate = strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                ripple_render = parserender(optarg);
+                break;
+            case 's':
+                duration = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                errx(1, "usage: %s [-j threads] [-n engines] [-p presses/s] [-r render] [-s seconds]", argv[0]);
+        }
+    }
+
+    if (!threads || !count) {
+        errx(1, "need at least one thread and one engine");
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    duration *= 1000;
+
+    engines = calloc(count, sizeof(*engines));
+    workers = calloc(threads, sizeof(*workers));
+    if (!engines || !workers) {
+        err(1, "calloc");
+    }
+
+    start = emu_now();
+
+    first = 0;
+    for (size_t i = 0; i < threads; i++) {
+        workers[i] = (worker_t){
+            .engines = engines,
+            .first = first,
+            .count = count / threads + (i < count % threads),
+        };
+        first += workers[i].count;
+
+        if ((errno = pthread_create(&workers[i].thread, NULL, work, &workers[i]))) {
+            err(1, "pthread_create");
+        }
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        if ((errno = pthread_join(workers[i].thread, NULL))) {
+            err(1, "pthread_join");
+        }
+    }
+
+    secs = (emu_now() - start) / 1e9;
+
+    /* engines in order, so the threads can't change it */
+    checksum = 0xcbf29ce484222325ULL;
+    frames = 0;
+    presses = 0;
+    for (size_t i = 0; i < count; i++) {
+        checksum = fnv(checksum, (const uint8_t *)&engines[i].hash, sizeof(engines[i].hash));
+        frames += engines[i].frames;
+        presses += engines[i].presses;
+    }
+
+    printf("%s: %zu engines on %zu threads, %" PRIu32 " s each\n",
+        ripple_render_names[ripple_render], count, threads, duration / 1000);
+    printf("%" PRIu64 " presses, %" PRIu64 " frames in %.3f s, %.0f frames/s, %.0fx real time\n",
+        presses, frames, secs, frames / secs, (double)count * duration / 1000 / secs);
+    printf("checksum %016" PRIx64 "\n", checksum);
+
+    free(workers);
+    free(engines);
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * headless replay of a key event trace on both halves of the split.
+ *
+ * the process forks into a master and a slave, each with its own
+ * firmware and display, linked by a socketpair that stands in for the
+ * split serial link. the master sees every key event, like it does on
+ * the keyboard, and its split transactions go over the link to the
+ * slave. time is simulated in 1 ms ticks, the master sends every tick
+ * after that ms's transactions so the two run in lockstep. for every
+ * frame a display changed, one line is printed:
+ *
+ *     <m | s> <ms> <fnv-1a hash of the frame> <i2c bytes for the frame>
+ *
+ * and at the end, the traffic on the link is reported on stderr.
+ *
+ * usage: split [-t tail ms] trace
+ *
+ *   -t  keep running this long after the last event (default 6000)
+ *
+ * see trace.h for the trace format.
+ */
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "emu.h"
+#include "trace.h"
+#include "../ripple.h"
+
+/* messages that aren't transactions */
+#define LINK_TICK -1
+#define LINK_DONE -2
+
+/*
+ * bytes a transaction costs besides its payload: qmk sends the id and
+ * both buffer sizes ahead of the rpc data
+ */
+#define LINK_OVERHEAD 3
+
+typedef struct message message_t;
+
+struct message {
+    uint32_t ms;
+    int8_t id;
+    uint8_t len;
+    uint8_t data[RPC_M2S_BUFFER_SIZE];
+};
+
+static int sock = -1;
+static uint32_t now = 0;
+
+/* traffic the master put on the link */
+static struct {
+    uint32_t transactions;
+    uint32_t bytes;
+} traffic;
+
+static void post(int8_t id, uint8_t len, const void *data)
+{
+    message_t m;
+
+    m = (message_t){
+        .ms = now,
+        .id = id,
+        .len = len,
+    };
+    if (len) {
+        memcpy(m.data, data, len);
+    }
+
+    if (send(sock, &m, sizeof(m), 0) != sizeof(m)) {
+        err(1, "send");
+    }
+}
+
+static bool forward(int8_t id, uint8_t len, const void *data)
+{
+    post(id, len, data);
+
+    traffic.transactions++;
+    traffic.bytes += LINK_OVERHEAD + len;
+
+    return true;
+}
+
+static uint32_t frame(char side, uint32_t ms)
+{
+    oled_task_user();
+
+    if (!emu_dirty()) {
+        return 0;
+    }
+
+    oled_render();
+
+    printf("%c %" PRIu32 " %016" PRIx64 " %" PRIu32 "\n",
+        side, ms, emu_frame_hash(), emu_bus_bytes());
+
+    return 1;
+}
+
+static void slave(void)
+{
+    message_t m;
+    uint32_t frames;
+    ssize_t n;
+
+    emu_set_master(false);
+    ripple_stats_interval = 0;
+    emu_timer_set(0);
+    keyboard_post_init_user();
+    oled_init_user(OLED_ROTATION_0);
+
+    frames = 0;
+    for (;;) {
+        n = recv(sock, &m, sizeof(m), 0);
+        if (n == -1) {
+            err(1, "recv");
+        }
+        if (n != sizeof(m)) {
+            errx(1, "slave: link closed");
+        }
+
+        emu_timer_set(m.ms);
+
+        if (m.id == LINK_DONE) {
+            break;
+        } else if (m.id == LINK_TICK) {
+            frames += frame('s', m.ms);
+        } else if (!emu_rpc(m.id, m.len, m.data)) {
+            errx(1, "slave: no handler for transaction %d", m.id);
+        }
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "slave: %" PRIu32 " frames\n", frames);
+}
+
+static int master(const trace_t *trace, uint32_t end, pid_t pid)
+{
+    keyrecord_t r;
+    int status;
+    uint32_t presses;
+    uint32_t frames;
+    size_t next;
+
+    emu_set_link(forward);
+    ripple_stats_interval = 0;
+    emu_timer_set(0);
+    keyboard_post_init_user();
+    oled_init_user(OLED_ROTATION_0);
+
+    next = 0;
+    frames = 0;
+    presses = 0;
+    for (now = 0; now <= end; now++) {
+        emu_timer_set(now);
+
+        for (; next < trace->len && trace->events[next].ms <= now; next++) {
+            presses += trace->events[next].pressed;
+
+            r = trace_record(&trace->events[next]);
+            process_record_user(0, &r);
+        }
+
+        housekeeping_task_user();
+        post(LINK_TICK, 0, NULL);
+
+        frames += frame('m', now);
+    }
+
+    post(LINK_DONE, 0, NULL);
+    fflush(stdout);
+
+    /* let the slave finish, so the report comes last */
+    if (waitpid(pid, &status, 0) == -1) {
+        err(1, "waitpid");
+    }
+
+    fprintf(stderr, "master: %" PRIu32 " frames\n", frames);
+    fprintf(stderr, "link: %" PRIu32 " presses, %" PRIu32 " transactions, %" PRIu32 " bytes, %.2f bytes/press\n",
+        presses,
+        traffic.transactions,
+        traffic.bytes,
+        presses ? (double)traffic.bytes / presses : 0.0);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+int main(int argc, char **argv)
+{
+    trace_t trace = {0};
+    uint32_t tail;
+    int fds[2];
+    int status;
+    pid_t pid;
+    int opt;
+
+    tail = 6000;
+
+    while ((opt = getopt(argc, argv, "t:")) != -1) {
+        switch (opt) {
+            case 't':
+                tail = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                errx(1, "usage: %s [-t tail ms] trace", argv[0]);
+        }
+    }
+
+    if (optind != argc - 1) {
+        errx(1, "usage: %s [-t tail ms] trace", argv[0]);
+    }
+
+    trace_read(&trace, argv[optind]);
+
+    /* seqpacket keeps each message whole */
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == -1) {
+        err(1, "socketpair");
+    }
+
+    /* whole lines, so the halves don't interleave mid line */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fflush(stdout);
+
+    pid = fork();
+    if (pid == -1) {
+        err(1, "fork");
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        sock = fds[1];
+        slave();
+        return 0;
+    }
+
+    close(fds[1]);
+    sock = fds[0];
+    status = master(&trace, trace_end(&trace) + tail, pid);
+
+    trace_free(&trace);
+
+    return status;
+}
@@ -0,0 +1,116 @@
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+void trace_read(trace_t *t, const char *path)
+{
+    FILE *f;
+    char line[128];
+    char *p;
+    unsigned ms, row, col, pressed;
+    size_t lineno;
+
+    f = fopen(path, "r");
+    if (!f) {
+        err(1, "%s", path);
+    }
+
+    lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+
+        /* blank, maybe with a \r from a dos line ending, or a comment */
+        p = line + strspn(line, " \t\r\n");
+        if (*p == '#' || *p == '\0') {
+            continue;
+        }
+
+        if (sscanf(p, "%u %u %u %u", &ms, &row, &col, &pressed) != 4) {
+            errx(1, "%s:%zu: expected <ms> <row> <col> <pressed>", path, lineno);
+        }
+
+        if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            errx(1, "%s:%zu: key %u,%u outside the matrix", path, lineno, row, col);
+        }
+
+        if (t->len && ms < t->events[t->len - 1].ms) {
+            errx(1, "%s:%zu: events out of order", path, lineno);
+        }
+
+        trace_add(t, (event_t){
+            .ms = ms,
+            .row = row,
+            .col = col,
+            .pressed = pressed,
+        });
+    }
+
+    if (ferror(f)) {
+        err(1, "%s", path);
+    }
+
+    fclose(f);
+}
+
+void trace_add(trace_t *t, event_t e)
+{
+    if (t->len == t->cap) {
+        t->cap = t->cap ? t->cap * 2 : 64;
+        t->events = realloc(t->events, t->cap * sizeof(*t->events));
+        if (!t->events) {
+            err(1, "realloc");
+        }
+    }
+
+    t->events[t->len++] = e;
+}
+
+void trace_write(const trace_t *t, const char *path, const char *comment)
+{
+    FILE *f;
+
+    f = fopen(path, "w");
+    if (!f) {
+        err(1, "%s", path);
+    }
+
+    fprintf(f, "# %s\n# <ms> <row> <col> <pressed>\n", comment);
+    for (size_t i = 0; i < t->len; i++) {
+        fprintf(f, "%u %u %u %u\n",
+            (unsigned)t->events[i].ms,
+            t->events[i].row,
+            t->events[i].col,
+            t->events[i].pressed);
+    }
+
+    if (fclose(f) == EOF) {
+        err(1, "%s", path);
+    }
+}
+
+void trace_free(trace_t *t)
+{
+    free(t->events);
+    *t = (trace_t){0};
+}
+
+uint32_t trace_end(const trace_t *t)
+{
+    return t->len ? t->events[t->len - 1].ms : 0;
+}
+
+keyrecord_t trace_record(const event_t *e)
+{
+    keyrecord_t r;
+
+    memset(&r, 0, sizeof(r));
+    r.event.key.row = e->row;
+    r.event.key.col = e->col;
+    r.event.pressed = e->pressed;
+    r.event.time = e->ms;
+
+    return r;
+}
@@ -0,0 +1,47 @@
+#ifndef trace_h_INCLUDED
+#define trace_h_INCLUDED
+
+#include "qmk.h"
+
+/*
+ * key event traces for the headless frontends. a trace has one key
+ * event per line, ordered by time:
+ *
+ *     <ms> <row> <col> <1 pressed | 0 released>
+ *
+ * blank lines and lines starting with #, after any leading whitespace,
+ * are ignored.
+ */
+
+typedef struct event event_t;
+
+struct event {
+    uint32_t ms;
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+};
+
+typedef struct trace trace_t;
+
+struct trace {
+    event_t *events;
+    size_t len;
+    size_t cap;
+};
+
+/* append the events in path to t, exits on any error */
+void trace_read(trace_t *t, const char *path);
+/* append an event, they must stay ordered by time */
+void trace_add(trace_t *t, event_t e);
+/* write t to path, with a comment line first, exits on any error */
+void trace_write(const trace_t *t, const char *path, const char *comment);
+void trace_free(trace_t *t);
+
+/* ms of the last event, 0 for an empty trace */
+uint32_t trace_end(const trace_t *t);
+
+/* the event as qmk would hand it to process_record_user */
+keyrecord_t trace_record(const event_t *e);
+
+#endif // trace_h_INCLUDED
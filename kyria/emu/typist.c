@@ -0,0 +1,433 @@
+/*
+ * synthetic typing, played headless into the firmware to see how the
+ * ripple engine holds up.
+ *
+ * words of 1 to 7 letters and a space are typed in bursts, with a
+ * pause between bursts. presses within a burst come at the given wpm,
+ * 5 presses to a word, each gap and hold and pause varying by half
+ * either way. letters fall on the two halves of the kyria's matrix in
+ * the given proportion, the space on either thumb. the trace is
+ * replayed like replay does, in simulated 1 ms ticks, and at the end
+ * the pressure on the ripple pool and the host time per frame are
+ * reported. built with KEYSTATS=1, so is the wpm the firmware measured.
+ *
+ * usage: typist [-b words] [-h hold ms] [-l left %] [-o trace] [-p pause ms]
+ *               [-r render] [-S seed] [-s seconds] [-w wpm]
+ *
+ *   -b  words per burst (default 10)
+ *   -h  how long keys are held (default 100)
+ *   -l  share of the letters typed on the left half (default 50)
+ *   -o  also write the typing as a trace for replay and split
+ *   -p  pause between bursts (default 2000)
+ *   -r  ring rasterizer: pixel, bytes or atlas
+ *   -S  seed, the same seed types the same keys (default 1)
+ *   -s  seconds of typing (default 60)
+ *   -w  words per minute within a burst (default 60)
+ *
+ * see trace.h for the trace format.
+ */
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "emu.h"
+#include "trace.h"
+#include "../ripple.h"
+
+#ifdef KEYSTATS_ENABLE
+#include "../keystats.h"
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#if MATRIX_ROWS != 8 || MATRIX_COLS < 8
+#error "typist types on the kyria's 8x8 matrix"
+#endif
+
+/* letters per word, and presses counted per word for the wpm */
+#define WORD_MIN 1
+#define WORD_MAX 7
+#define WORD_PRESSES 5
+
+/* keep running after the last event until every ripple has faded */
+#define TAIL (RIPPLE_TIMEOUT + 1000)
+
+typedef struct typing typing_t;
+
+struct typing {
+    uint16_t wpm;
+    uint16_t burst;
+    uint16_t pause;
+    uint16_t hold;
+    uint8_t left;
+
+    /* xorshift32 state */
+    uint32_t state;
+    /* when each key is let go */
+    uint32_t held[MATRIX_ROWS][MATRIX_COLS];
+};
+
+/*
+ * a half is rows 0-3 on the left and 4-7 on the right: two rows of 6
+ * letters, a row of 6 and 2 more by the thumbs, and 5 thumb keys
+ */
+#define HALF_ROWS 4
+#define THUMB_ROW 3
+#define THUMB_COL 3
+#define SPACE_COL 6
+
+static uint32_t next(typing_t *t)
+{
+    t->state ^= t->state << 13;
+    t->state ^= t->state >> 17;
+    t->state ^= t->state << 5;
+
+    return t->state;
+}
+
+/* around mean, by up to half of it either way */
+static uint32_t vary(typing_t *t, uint32_t mean)
+{
+    return mean / 2 + next(t) % (mean + 1);
+}
+
+/* a letter key on one half, not a thumb key */
+static keypos_t letter(typing_t *t, bool right)
+{
+    keypos_t k;
+
+    k.row = next(t) % THUMB_ROW;
+    k.col = next(t) % (k.row == THUMB_ROW - 1 ? 8 : 6);
+    k.row += right ? HALF_ROWS : 0;
+
+    return k;
+}
+
+static void press(typing_t *t, trace_t *trace, uint32_t ms, keypos_t k)
+{
+    uint32_t up;
+
+    up = ms + MAX(vary(t, t->hold), 1);
+    t->held[k.row][k.col] = up;
+
+    trace_add(trace, (event_t){ .ms = ms, .row = k.row, .col = k.col, .pressed = true });
+    trace_add(trace, (event_t){ .ms = up, .row = k.row, .col = k.col, .pressed = false });
+}
+
+/* releases first, then by key, so the order doesn't depend on qsort */
+static int compare(const void *a, const void *b)
+{
+    const event_t *x = a;
+    const event_t *y = b;
+
+    if (x->ms != y->ms) {
+        return x->ms < y->ms ? -1 : 1;
+    }
+    if (x->pressed != y->pressed) {
+        return x->pressed - y->pressed;
+    }
+    if (x->row != y->row) {
+        return x->row - y->row;
+    }
+
+    return x->col - y->col;
+}
+
+static void type(typing_t *t, trace_t *trace, uint32_t duration)
+{
+    keypos_t k;
+    uint32_t gap;
+    uint32_t ms;
+    uint16_t words;
+    uint8_t letters;
+    bool right;
+
+    /* ms between presses, WORD_PRESSES to a word */
+    gap = MAX(60000 / ((uint32_t)t->wpm * WORD_PRESSES), 1);
+
+    ms = 500;
+    while (ms < duration) {
+        words = MAX(vary(t, t->burst), 1);
+
+        for (uint16_t w = 0; w < words && ms < duration; w++) {
+            letters = WORD_MIN + next(t) % (WORD_MAX - WORD_MIN + 1);
+
+            for (uint8_t i = 0; i < letters; i++) {
+                /* a key still down can't be pressed again, pick another */
+                do {
+                    right = next(t) % 100 >= t->left;
+                    k = letter(t, right);
+                } while (t->held[k.row][k.col] >= ms);
+
+                press(t, trace, ms, k);
+                ms += vary(t, gap);
+            }
+
+            right = next(t) & 1;
+            k.row = THUMB_ROW + (right ? HALF_ROWS : 0);
+            k.col = right ? THUMB_COL + 7 - SPACE_COL : SPACE_COL;
+            if (t->held[k.row][k.col] >= ms) {
+                ms = t->held[k.row][k.col] + 1;
+            }
+
+            press(t, trace, ms, k);
+            ms += vary(t, gap);
+        }
+
+        ms += vary(t, t->pause);
+    }
+
+    qsort(trace->events, trace->len, sizeof(*trace->events), compare);
+}
+
+/* the most presses within any span of ms */
+static uint32_t busiest(const trace_t *trace, uint32_t span)
+{
+    uint32_t most;
+    uint32_t n;
+    size_t first;
+
+    most = 0;
+    n = 0;
+    first = 0;
+
+    for (size_t i = 0; i < trace->len; i++) {
+        if (!trace->events[i].pressed) {
+            continue;
+        }
+
+        n++;
+        for (; trace->events[first].ms + span <= trace->events[i].ms; first++) {
+            n -= trace->events[first].pressed;
+        }
+
+        most = MAX(most, n);
+    }
+
+    return most;
+}
+
+static int compare64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint8_t parserender(const char *name)
+{
+    for (uint8_t i = 0; i < RIPPLE_RENDER_COUNT; i++) {
+        if (strcmp(name, ripple_render_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    errx(1, "unknown render %s", name);
+}
+
+static void usage(const char *argv0)
+{
+    errx(1, "usage: %s [-b words] [-h hold ms] [-l left %%] [-o trace] [-p pause ms] "
+        "[-r render] [-S seed] [-s seconds] [-w wpm]", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    typing_t t = {0};
+    trace_t trace = {0};
+    ripple_stats_t *s;
+    keyrecord_t r;
+    const char *out;
+    char comment[128];
+    uint64_t *ns;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t duration;
+    uint32_t seed;
+    uint32_t presses;
+    uint32_t frames;
+    uint32_t drawn;
+    uint32_t full;
+    uint32_t end;
+    uint8_t alive;
+#ifdef KEYSTATS_ENABLE
+    uint64_t wpm_sum;
+    uint32_t wpm_frames;
+    uint16_t wpm_max;
+    uint16_t wpm;
+#endif
+    size_t ev;
+    int opt;
+
+    t.wpm = 60;
+    t.burst = 10;
+    t.pause = 2000;
+    t.hold = 100;
+    t.left = 50;
+    seed = 1;
+    duration = 60;
+    out = NULL;
+
+    while ((opt = getopt(argc, argv, "b:h:l:o:p:r:S:s:w:")) != -1) {
+        switch (opt) {
+            case 'b':
+                t.burst = strtoul(optarg, NULL, 10);
+                break;
+            case 'h':
+                t.hold = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                t.left = strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                out = optarg;
+                break;
+            case 'p':
+                t.pause = strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                ripple_render = parserender(optarg);
+                break;
+            case 'S':
+                seed = strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                duration = strtoul(optarg, NULL, 10);
+                break;
+            case 'w':
+                t.wpm = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (optind != argc) {
+        usage(argv[0]);
+    }
+    if (!t.wpm || !seed || t.left > 100) {
+        errx(1, "need a wpm, a nonzero seed and at most 100%% on the left");
+    }
+
+    t.state = seed;
+    type(&t, &trace, duration * 1000);
+
+    if (out) {
+        snprintf(comment, sizeof(comment), "typist -b %u -h %u -l %u -p %u -S %" PRIu32 " -s %" PRIu32 " -w %u",
+            t.burst, t.hold, t.left, t.pause, seed, duration, t.wpm);
+        trace_write(&trace, out, comment);
+    }
+
+    end = trace_end(&trace) + TAIL;
+    ns = calloc(end / RIPPLE_FRAMETIME + 1, sizeof(*ns));
+    if (!ns) {
+        err(1, "calloc");
+    }
+
+    /* the summary below has the stats, not the console */
+    ripple_stats_interval = 0;
+#ifdef KEYSTATS_ENABLE
+    keystats_interval = 0;
+    wpm_sum = 0;
+    wpm_frames = 0;
+    wpm_max = 0;
+#endif
+
+    emu_timer_set(0);
+    keyboard_post_init_user();
+    oled_init_user(OLED_ROTATION_0);
+
+    s = &ripple_ctx()->stats;
+    *s = (ripple_stats_t){0};
+
+    presses = 0;
+    drawn = 0;
+    full = 0;
+    alive = 0;
+    ev = 0;
+    for (uint32_t ms = 0; ms <= end; ms++) {
+        emu_timer_set(ms);
+
+        for (; ev < trace.len && trace.events[ev].ms <= ms; ev++) {
+            r = trace_record(&trace.events[ev]);
+            presses += r.event.pressed;
+            process_record_user(0, &r);
+        }
+
+        /* no slave, its transactions go nowhere */
+        housekeeping_task_user();
+
+        frames = s->frames;
+        start = emu_now();
+        oled_task_user();
+        elapsed = emu_now() - start;
+
+        if (s->frames != frames) {
+            ns[drawn++] = elapsed;
+            alive = MAX(alive, ripple_ctx()->alive);
+            full += ripple_ctx()->alive == RIPPLE_MAX;
+
+#ifdef KEYSTATS_ENABLE
+            /* averaged over the frames with typing in the window */
+            wpm = keystats_wpm();
+            wpm_max = MAX(wpm_max, wpm);
+            if (wpm) {
+                wpm_sum += wpm;
+                wpm_frames++;
+            }
+#endif
+        }
+
+        if (emu_dirty()) {
+            oled_render();
+        }
+    }
+
+    qsort(ns, drawn, sizeof(*ns), compare64);
+
+    printf("%s: %" PRIu32 " s at %u wpm, bursts of %u words, %u ms pauses, %u ms holds, %u%% left\n",
+        ripple_render_names[ripple_render], duration, t.wpm, t.burst, t.pause, t.hold, t.left);
+    printf("%" PRIu32 " presses, %.1f wpm overall, at most %" PRIu32 " in a second and %" PRIu32 " within RIPPLE_TIMEOUT\n",
+        presses,
+        presses * 60000.0 / WORD_PRESSES / MAX(trace_end(&trace), 1),
+        busiest(&trace, 1000),
+        busiest(&trace, RIPPLE_TIMEOUT));
+#ifdef KEYSTATS_ENABLE
+    printf("keystats: %u wpm at most, %.1f on average while typing\n",
+        wpm_max,
+        wpm_frames ? (double)wpm_sum / wpm_frames : 0.0);
+#endif
+    printf("pool of %d: %" PRIu32 " merged, %" PRIu32 " evicted, %" PRIu32 " dropped, %" PRIu32 " unsent, %.1f alive on average, %u at most, full in %.1f%% of frames\n",
+        RIPPLE_MAX,
+        s->merged,
+        s->evicted,
+        s->dropped,
+        s->unsent,
+        drawn ? (double)s->alive / drawn : 0.0,
+        alive,
+        drawn ? full * 100.0 / drawn : 0.0);
+    if (drawn) {
+        printf("%" PRIu32 " frames, %" PRIu64 " ns median, %" PRIu64 " p99, %" PRIu64 " max, %.1f circles, %.1f thinned and %.1f steps a frame\n",
+            drawn,
+            ns[drawn / 2],
+            ns[drawn * 99 / 100],
+            ns[drawn - 1],
+            (double)s->circles / drawn,
+            (double)s->thinned / drawn,
+            (double)s->steps / drawn);
+    }
+
+    free(ns);
+    trace_free(&trace);
+
+    return 0;
+}
@@ -25,12 +25,62 @@
 #endif  // #ifndef QMK_EMULATOR
 
 
+#include "comp.h"
 #include "ripple.h"
 
+#ifdef WATER_ENABLE
+#include "water.h"
+#endif
+
+#if defined(STATUS_ENABLE) || defined(KEYSTATS_ENABLE)
+#include <string.h>
+
+#include "widget.h"
+#endif
+
+#ifdef KEYSTATS_ENABLE
+#include "keystats.h"
+#endif
+
+#ifdef PUSHEEN_ENABLE
+#include "anim.h"
+#include "pusheen_anim.h"
+
+#ifndef PUSHEEN_FRAMETIME
+#define PUSHEEN_FRAMETIME 500
+#endif
+
+static uint8_t pusheen_buf[PUSHEEN_ANIM_PAGES * OLED_DISPLAY_WIDTH];
+
+static void play_pusheen(void);
+
+/* over the ripples, which show through inverted */
+static comp_layer_t pusheen_layer = {
+    .name = "pusheen",
+    .buf = pusheen_buf,
+    .width = OLED_DISPLAY_WIDTH,
+    .pages = PUSHEEN_ANIM_PAGES,
+    .blend = COMP_XOR,
+    .update = play_pusheen,
+};
+
+static anim_t pusheen = {
+    .data = pusheen_anim,
+    .size = sizeof(pusheen_anim),
+    .loop = PUSHEEN_ANIM_LOOP,
+    .frametime = PUSHEEN_FRAMETIME,
+    .layer = &pusheen_layer,
+};
+
+static void play_pusheen(void)
+{
+    anim_play(&pusheen);
+}
+#endif
+
 #define KC_LANG KC_LEFT_ANGLE_BRACKET
 #define KC_RANG KC_RIGHT_ANGLE_BRACKET
 
-#ifndef QMK_EMULATOR
 enum layers {
     _QWERTY = 0,
     _LOWER,
@@ -38,6 +88,206 @@ enum layers {
     _ADJUST,
 };
 
+#ifdef STATUS_ENABLE
+/*
+ * the layer, the mods held and the lock leds along the bottom page,
+ * each a widget over the ripples that hides them
+ */
+#define STATUS_PAGE (OLED_DISPLAY_HEIGHT / 8 - 1)
+
+#define LAYER_NAME_CHARS 6
+#define MODS_CHARS 4
+#define LOCKS_CHARS 8
+
+static const char PROGMEM layer_names[][LAYER_NAME_CHARS] = {
+    [_QWERTY] = "QWERTY",
+    [_LOWER] = "LOWER",
+    [_RAISE] = "RAISE",
+    [_ADJUST] = "ADJUST",
+};
+
+static uint16_t read_layer_name(void)
+{
+    return get_highest_layer(layer_state);
+}
+
+static uint8_t format_layer_name(uint16_t layer, char *text)
+{
+    char ch;
+
+    if (layer >= sizeof(layer_names) / sizeof(layer_names[0])) {
+        text[0] = 'L';
+        text[1] = '0' + layer / 10;
+        text[2] = '0' + layer % 10;
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < LAYER_NAME_CHARS && (ch = pgm_read_byte(&layer_names[layer][i])); i++) {
+        text[i] = ch;
+    }
+
+    return 0;
+}
+
+/* ctrl, shift, alt and gui in bits 0-3, either side */
+static uint16_t read_mods(void)
+{
+    uint8_t mods = get_mods();
+
+    return (mods | mods >> 4) & 0x0f;
+}
+
+/* the mods held are inverted */
+static uint8_t format_mods(uint16_t mods, char *text)
+{
+    memcpy(text, "CSAG", MODS_CHARS);
+
+    return mods;
+}
+
+static uint16_t read_locks(void)
+{
+    led_t leds = host_keyboard_led_state();
+
+    return leds.caps_lock | leds.num_lock << 1;
+}
+
+static uint8_t format_locks(uint16_t locks, char *text)
+{
+    memcpy(text, "CAPS NUM", LOCKS_CHARS);
+
+    return (locks & 1 ? 0x0f : 0) | (locks & 2 ? 0xe0 : 0);
+}
+
+static uint8_t layer_name_buf[LAYER_NAME_CHARS * WIDGET_GLYPH];
+static uint8_t mods_buf[MODS_CHARS * WIDGET_GLYPH];
+static uint8_t locks_buf[LOCKS_CHARS * WIDGET_GLYPH];
+
+static void update_layer_name(void);
+static void update_mods(void);
+static void update_locks(void);
+
+static comp_layer_t layer_name_layer = {
+    .name = "layer",
+    .buf = layer_name_buf,
+    .x = 0,
+    .page = STATUS_PAGE,
+    .width = sizeof(layer_name_buf),
+    .pages = 1,
+    .blend = COMP_COPY,
+    .update = update_layer_name,
+};
+
+static comp_layer_t mods_layer = {
+    .name = "mods",
+    .buf = mods_buf,
+    .x = (OLED_DISPLAY_WIDTH - sizeof(locks_buf) + sizeof(layer_name_buf) - sizeof(mods_buf)) / 2,
+    .page = STATUS_PAGE,
+    .width = sizeof(mods_buf),
+    .pages = 1,
+    .blend = COMP_COPY,
+    .update = update_mods,
+};
+
+static comp_layer_t locks_layer = {
+    .name = "locks",
+    .buf = locks_buf,
+    .x = OLED_DISPLAY_WIDTH - sizeof(locks_buf),
+    .page = STATUS_PAGE,
+    .width = sizeof(locks_buf),
+    .pages = 1,
+    .blend = COMP_COPY,
+    .update = update_locks,
+};
+
+static widget_t layer_name_widget = {
+    .read = read_layer_name,
+    .format = format_layer_name,
+    .layer = &layer_name_layer,
+};
+
+static widget_t mods_widget = {
+    .read = read_mods,
+    .format = format_mods,
+    .layer = &mods_layer,
+};
+
+static widget_t locks_widget = {
+    .read = read_locks,
+    .format = format_locks,
+    .layer = &locks_layer,
+};
+
+static void update_layer_name(void)
+{
+    widget_update(&layer_name_widget);
+}
+
+static void update_mods(void)
+{
+    widget_update(&mods_widget);
+}
+
+static void update_locks(void)
+{
+    widget_update(&locks_widget);
+}
+#endif
+
+#ifdef KEYSTATS_ENABLE
+/* the typing speed in the top right corner, keystats_layer's heatmap is in the top left */
+#define WPM_CHARS 7
+
+static uint16_t read_wpm(void)
+{
+    uint16_t wpm = keystats_wpm();
+
+    return wpm < 999 ? wpm : 999;
+}
+
+static uint8_t format_wpm(uint16_t wpm, char *text)
+{
+    memcpy(text, "    WPM", WPM_CHARS);
+
+    text[2] = '0' + wpm % 10;
+    if (wpm >= 10) {
+        text[1] = '0' + wpm / 10 % 10;
+    }
+    if (wpm >= 100) {
+        text[0] = '0' + wpm / 100;
+    }
+
+    return 0;
+}
+
+static uint8_t wpm_buf[WPM_CHARS * WIDGET_GLYPH];
+
+static void update_wpm(void);
+
+static comp_layer_t wpm_layer = {
+    .name = "wpm",
+    .buf = wpm_buf,
+    .x = OLED_DISPLAY_WIDTH - sizeof(wpm_buf),
+    .page = 0,
+    .width = sizeof(wpm_buf),
+    .pages = 1,
+    .blend = COMP_COPY,
+    .update = update_wpm,
+};
+
+static widget_t wpm_widget = {
+    .read = read_wpm,
+    .format = format_wpm,
+    .layer = &wpm_layer,
+};
+
+static void update_wpm(void)
+{
+    widget_update(&wpm_widget);
+}
+#endif
+
+#ifndef QMK_EMULATOR
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 /*
  * Base Layer: QWERTY
@@ -131,6 +381,37 @@ layer_state_t layer_state_set_user(layer_state_t state)
 oled_rotation_t oled_init_user(oled_rotation_t rotation)
 {
     ripple_init();
+#ifdef WATER_ENABLE
+    /*
+     * the ripples only place the drops, the water borrows their frame
+     * if they have one. they're never rendered, so they keep no pool
+     * to age out.
+     */
+    ripple_ctx()->spawned = water_drop;
+    ripple_ctx()->place_only = true;
+    water_init(ripple_layer.buf);
+    comp_add(&water_layer);
+#else
+    comp_add(&ripple_layer);
+#endif
+#ifdef PUSHEEN_ENABLE
+    anim_init(&pusheen);
+    comp_add(&pusheen_layer);
+#endif
+#ifdef STATUS_ENABLE
+    widget_init(&layer_name_widget);
+    widget_init(&mods_widget);
+    widget_init(&locks_widget);
+    comp_add(&layer_name_layer);
+    comp_add(&mods_layer);
+    comp_add(&locks_layer);
+#endif
+#ifdef KEYSTATS_ENABLE
+    keystats_init();
+    widget_init(&wpm_widget);
+    comp_add(&keystats_layer);
+    comp_add(&wpm_layer);
+#endif
 
     if (!is_keyboard_master()) {
         return OLED_ROTATION_180;
@@ -149,14 +430,56 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record)
     (void)keycode;
 
     process_record_ripples(record);
+#ifdef KEYSTATS_ENABLE
+    keystats_record(record);
+#endif
 
     return true;
 }
 
 bool oled_task_user(void)
 {
-    oled_write_ripples();
+    comp_task();
 
     return false;
 }
+
+#ifdef RIPPLE_SYNC_ENABLE
+/* the emulator's qmk.h has the transactions */
+#ifndef QMK_EMULATOR
+#include "transactions.h"
+#endif
+
+static void ripple_sync_slave(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data)
+{
+    (void)out_buflen;
+    (void)out_data;
+
+    ripple_sync_unpack(in_data, in_buflen);
+}
+
+void keyboard_post_init_user(void)
+{
+    transaction_register_rpc(RIPPLE_SYNC, ripple_sync_slave);
+}
+
+/*
+ * once per scan, send the ripples spawned during it in one batch. if
+ * the slave isn't there, they are lost along with the transaction.
+ */
+void housekeeping_task_user(void)
+{
+    uint8_t buf[RPC_M2S_BUFFER_SIZE];
+    uint8_t len;
+
+    if (!is_keyboard_master()) {
+        return;
+    }
+
+    len = ripple_sync_pack(buf, sizeof(buf));
+    if (len) {
+        transaction_rpc_send(RIPPLE_SYNC, len, buf);
+    }
+}
+#endif
 #endif
@@ -0,0 +1,287 @@
+#ifdef OLED_ENABLE
+#include "keystats.h"
+
+#include <string.h>
+
+#ifndef QMK_EMULATOR
+#include "print.h"
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* the window the wpm is over, in ms */
+#define WINDOW ((uint32_t)KEYSTATS_BUCKETS * KEYSTATS_BUCKET)
+
+#if KEYSTATS_BUCKETS * KEYSTATS_BUCKET > 0x7fff
+#error "KEYSTATS_BUCKETS * KEYSTATS_BUCKET must stay within half the timer's wrap"
+#endif
+
+/* presses per word, for the wpm */
+#define WORD 5
+
+/* the heatmap: a square of CELL px per key, 3 px of it lit at most */
+#define HALF_ROWS (MATRIX_ROWS / 2)
+#define CELL 4
+#define LIT 3
+#define WIDTH (2 * MATRIX_COLS * CELL)
+#define PAGES ((HALF_ROWS * CELL + 7) / 8)
+
+#if WIDTH > OLED_DISPLAY_WIDTH
+#error "the keystats heatmap is wider than the display"
+#endif
+
+#ifdef QMK_EMULATOR
+uint16_t keystats_interval = KEYSTATS_INTERVAL;
+
+#define INTERVAL keystats_interval
+#else
+#define INTERVAL KEYSTATS_INTERVAL
+#endif
+
+static uint8_t heatmap[PAGES * WIDTH];
+
+comp_layer_t keystats_layer = {
+    .name = "keystats",
+    .buf = heatmap,
+    .width = WIDTH,
+    .pages = PAGES,
+    .blend = COMP_COPY,
+    .update = keystats_task,
+};
+
+/*
+ * presses in each bucket, a ring with buckets[current] filling up now,
+ * and their sum
+ */
+static uint8_t buckets[KEYSTATS_BUCKETS];
+static uint8_t current;
+static uint16_t presses;
+/* when the current bucket started */
+static uint16_t started;
+
+static uint8_t heat[MATRIX_ROWS][MATRIX_COLS];
+/* when the keys last cooled off */
+static uint16_t cooled;
+/* the heat changed since the heatmap was drawn */
+static bool changed;
+
+#ifdef CONSOLE_ENABLE
+/* when the stats were last printed */
+static uint16_t reported;
+#endif
+
+/* 3x3 ordered dither, a pixel is lit while its rank is below the level */
+static const uint8_t PROGMEM ranks[LIT][LIT] = {
+    { 0, 7, 3 },
+    { 6, 5, 2 },
+    { 4, 1, 8 },
+};
+
+void keystats_init(void)
+{
+    memset(buckets, 0, sizeof(buckets));
+    current = 0;
+    presses = 0;
+    started = timer_read();
+
+    memset(heat, 0, sizeof(heat));
+    cooled = started;
+    changed = true;
+
+#ifdef CONSOLE_ENABLE
+    reported = started;
+#endif
+}
+
+/* empty the buckets that fell out of the window since the last call */
+static void advance(void)
+{
+    uint16_t elapsed;
+
+    elapsed = timer_elapsed(started);
+    if (elapsed < KEYSTATS_BUCKET) {
+        return;
+    }
+
+    /* a whole window since, none of it is left */
+    if (elapsed >= WINDOW) {
+        memset(buckets, 0, sizeof(buckets));
+        presses = 0;
+        started += elapsed - elapsed % KEYSTATS_BUCKET;
+        return;
+    }
+
+    for (; elapsed >= KEYSTATS_BUCKET; elapsed -= KEYSTATS_BUCKET) {
+        current = (current + 1) % KEYSTATS_BUCKETS;
+        presses -= buckets[current];
+        buckets[current] = 0;
+        started += KEYSTATS_BUCKET;
+    }
+}
+
+void keystats_record(keyrecord_t *record)
+{
+    uint8_t row = record->event.key.row;
+    uint8_t col = record->event.key.col;
+
+    if (!record->event.pressed) {
+        return;
+    }
+
+    advance();
+    if (buckets[current] < UINT8_MAX) {
+        buckets[current]++;
+        presses++;
+    }
+
+    if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+        heat[row][col] = MIN(heat[row][col] + KEYSTATS_HEAT, UINT8_MAX);
+        changed = true;
+    }
+}
+
+uint16_t keystats_wpm(void)
+{
+    advance();
+
+    return (uint32_t)presses * 60000 / (WORD * WINDOW);
+}
+
+uint8_t keystats_heat(uint8_t row, uint8_t col)
+{
+    return heat[row][col];
+}
+
+/* take 1 / 2^KEYSTATS_COOL off every key's heat, rounded up */
+static void cool(void)
+{
+    bool warm;
+
+    if (timer_elapsed(cooled) < KEYSTATS_DECAY) {
+        return;
+    }
+
+    cooled = timer_read();
+
+    warm = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (heat[row][col]) {
+                heat[row][col] -= (heat[row][col] + (1 << KEYSTATS_COOL) - 1) >> KEYSTATS_COOL;
+                warm = true;
+            }
+        }
+    }
+
+    changed |= warm;
+}
+
+/*
+ * draw a key's square at x of the heatmap, marking it if it changed.
+ * squares are half a page high, at the top of the page or the bottom.
+ * a cold key is a dot, so the keys show where they are, and a key
+ * pressed lately has 2 to all of its pixels lit.
+ */
+static void drawkey(uint8_t x, uint8_t page, uint8_t shift, uint8_t h)
+{
+    uint8_t level;
+    uint8_t bits;
+    uint8_t b;
+    uint8_t *dst;
+    bool dirty;
+
+    level = h ? 2 + ((uint16_t)h * (LIT * LIT - 1) >> 8) : 1;
+    dst = &heatmap[page * WIDTH + x];
+    dirty = false;
+
+    /* the columns past LIT are the gap to the next square, never lit */
+    for (uint8_t cx = 0; cx < LIT; cx++, dst++) {
+        bits = 0;
+        for (uint8_t cy = 0; cy < LIT; cy++) {
+            if (pgm_read_byte(&ranks[cy][cx]) < level) {
+                bits |= 1 << cy;
+            }
+        }
+
+        b = (*dst & ~(0x0f << shift)) | bits << shift;
+        if (*dst != b) {
+            *dst = b;
+            dirty = true;
+        }
+    }
+
+    if (dirty) {
+        comp_dirty(&keystats_layer, page, x, x + LIT);
+    }
+}
+
+/*
+ * the left half's columns from the left edge and the right half's from
+ * the right, so each half's outer column is on the outside
+ */
+static void draw(void)
+{
+    uint8_t y;
+    uint8_t x;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        y = row % HALF_ROWS * CELL;
+
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            x = row < HALF_ROWS ? col * CELL : WIDTH - (col + 1) * CELL;
+            drawkey(x, y / 8, y % 8, heat[row][col]);
+        }
+    }
+}
+
+#ifdef CONSOLE_ENABLE
+void keystats_report(void)
+{
+    char line[2 * MATRIX_COLS + 2];
+    uint8_t h;
+    char *p;
+
+    reported = timer_read();
+
+    uprintf("keys: %u wpm\n", keystats_wpm());
+
+    /* a digit per key for its heat, laid out like the heatmap */
+    for (uint8_t row = 0; row < HALF_ROWS; row++) {
+        p = line;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            h = heat[row][col];
+            *p++ = h ? '0' + ((uint16_t)h * 10 >> 8) : '.';
+        }
+        *p++ = ' ';
+        for (uint8_t col = MATRIX_COLS; col-- > 0;) {
+            h = heat[row + HALF_ROWS][col];
+            *p++ = h ? '0' + ((uint16_t)h * 10 >> 8) : '.';
+        }
+        *p = '\0';
+
+        uprintf("keys: %s\n", line);
+    }
+}
+#endif
+
+void keystats_task(void)
+{
+    advance();
+    cool();
+
+    if (changed) {
+        draw();
+        changed = false;
+    }
+
+#ifdef CONSOLE_ENABLE
+    if (INTERVAL && timer_elapsed(reported) >= INTERVAL) {
+        keystats_report();
+    }
+#endif
+}
+#else
+enum empty { NIL };
+#endif
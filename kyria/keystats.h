@@ -0,0 +1,74 @@
+#ifndef keystats_h_INCLUDED
+#define keystats_h_INCLUDED
+
+#ifdef OLED_ENABLE
+#ifndef QMK_EMULATOR
+#include QMK_KEYBOARD_H
+#else
+#include "emu/qmk.h"
+#endif
+
+#include "comp.h"
+
+/*
+ * typing speed and a heatmap of the keys, fed every key event and
+ * kept in a fixed few bytes whatever the typing. presses are counted
+ * in KEYSTATS_BUCKETS buckets of KEYSTATS_BUCKET ms each, and the wpm
+ * is those over the window they span, at 5 presses a word. only the
+ * master sees key events, the slave's stats stay empty.
+ */
+#ifndef KEYSTATS_BUCKET
+#define KEYSTATS_BUCKET 500
+#endif
+#ifndef KEYSTATS_BUCKETS
+#define KEYSTATS_BUCKETS 10
+#endif
+/* heat a press adds to its key, heat goes up to 255 */
+#ifndef KEYSTATS_HEAT
+#define KEYSTATS_HEAT 64
+#endif
+/* ms between the heat cooling off by 1 / 2^KEYSTATS_COOL */
+#ifndef KEYSTATS_DECAY
+#define KEYSTATS_DECAY 1000
+#endif
+#ifndef KEYSTATS_COOL
+#define KEYSTATS_COOL 3
+#endif
+/* ms between the stats printed to the console, 0 for never */
+#ifndef KEYSTATS_INTERVAL
+#define KEYSTATS_INTERVAL 10000
+#endif
+
+#ifdef QMK_EMULATOR
+/* emulator builds can change KEYSTATS_INTERVAL at run time */
+extern uint16_t keystats_interval;
+#endif
+
+/* forget everything typed so far */
+void keystats_init(void);
+/* count a key event, only presses count */
+void keystats_record(keyrecord_t *record);
+/* words per minute over the last KEYSTATS_BUCKETS * KEYSTATS_BUCKET ms */
+uint16_t keystats_wpm(void);
+/* how much a key was pressed lately, 0 to 255 */
+uint8_t keystats_heat(uint8_t row, uint8_t col);
+/*
+ * move the window on, cool the keys and redraw the heatmap if any of
+ * that changed it. it's keystats_layer's update.
+ */
+void keystats_task(void);
+
+#ifdef CONSOLE_ENABLE
+/* print the wpm and the heatmap, keystats_task does every KEYSTATS_INTERVAL */
+void keystats_report(void);
+#endif
+
+/*
+ * the heatmap as a compositor layer, a 4 px square per key, the left
+ * half's rows beside the right half's. the more heat the more of the
+ * square is lit, up to 3x3 px.
+ */
+extern comp_layer_t keystats_layer;
+
+#endif
+#endif // keystats_h_INCLUDED
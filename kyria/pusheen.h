@@ -5,7 +5,7 @@
 
 #define FRAMECOUNT (sizeof(pusheen) / sizeof(pusheen[0]))
 
-static const char PROGMEM pusheen[][OLED_MATRIX_SIZE] = {
+static const uint8_t PROGMEM pusheen[][OLED_MATRIX_SIZE] = {
     {
         // 'pusheen1', 128x32px
         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
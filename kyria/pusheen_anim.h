@@ -0,0 +1,57 @@
+#ifndef pusheen_anim_h_INCLUDED
+#define pusheen_anim_h_INCLUDED
+
+/* generated by emu/animgen.c from pusheen.h, do not edit */
+
+/* where the loop restarts, after the first frame */
+#define PUSHEEN_ANIM_LOOP 210
+/* pages from the top the frames cover */
+#define PUSHEEN_ANIM_PAGES 4
+
+static const uint8_t PROGMEM pusheen_anim[] = {
+    // frame 0, from a blank display
+    0x0f, 0xa0, 0x30, 0xc0, 0x70, 0x38, 0x18, 0x0c, 0x04, 0x0c, 0x18, 0x38, 0xe0, 0xc0, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0xe0, 0x70, 0x18, 0x0c, 0x04, 0x04, 0x04, 0x0c, 0x18, 0x70, 0xc0,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0xad, 0x96, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x60, 0x40, 0xc0, 0xe0, 0x3c,
+    0x0f, 0x01, 0x83, 0x02, 0x80, 0x80, 0x80, 0x81, 0x07, 0x07, 0x07, 0x01, 0xc7, 0x87, 0x01, 0x07,
+    0x07, 0x81, 0x02, 0x80, 0x80, 0x80, 0x84, 0x0b, 0x41, 0x61, 0x61, 0x61, 0x30, 0x30, 0x33, 0x3f,
+    0x1f, 0x0f, 0x0f, 0x07, 0x82, 0x10, 0x07, 0x0f, 0x0f, 0x0f, 0x0f, 0x03, 0x01, 0x03, 0x02, 0x06,
+    0x0c, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x8a, 0x05, 0xc0, 0xe0, 0xe0, 0xe0, 0xe0, 0xc0, 0x91,
+    0x95, 0x08, 0x02, 0x02, 0x02, 0x02, 0x02, 0x82, 0xfe, 0x1f, 0x01, 0x85, 0x03, 0x01, 0x03, 0x03,
+    0x03, 0x82, 0x05, 0x06, 0x06, 0x03, 0x07, 0x06, 0x02, 0x82, 0x02, 0x03, 0x03, 0x03, 0x84, 0x08,
+    0x02, 0x02, 0x03, 0x03, 0x03, 0x03, 0x01, 0x01, 0x01, 0x95, 0x11, 0x03, 0x0e, 0x38, 0xe0, 0x80,
+    0x80, 0x80, 0xc0, 0x60, 0xf0, 0xfc, 0xe7, 0xc3, 0x83, 0xc7, 0xe7, 0x3f, 0x0f, 0x91, 0x99, 0x02,
+    0xe0, 0xff, 0x03, 0xc1, 0x0b, 0x01, 0xff, 0xff, 0x7e, 0x30, 0x30, 0x18, 0x19, 0x0f, 0x07, 0x03,
+    0x01, 0x94,
+    // frame 1
+    0x0f, 0x9f, 0x0a, 0x80, 0x20, 0x40, 0x20, 0x14, 0x0a, 0x02, 0x0a, 0x14, 0x00, 0x90, 0x86, 0x07,
+    0x40, 0x90, 0x68, 0x14, 0x0a, 0x06, 0x06, 0x02, 0x83, 0x06, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x83, 0x01, 0x80, 0x80, 0x81, 0x02, 0x40, 0x40, 0x40, 0x81, 0x00, 0x80, 0xac, 0x95, 0x01,
+    0x60, 0x40, 0x82, 0x06, 0x40, 0x20, 0x20, 0x18, 0x22, 0x08, 0x01, 0x82, 0x02, 0x80, 0x40, 0x40,
+    0x82, 0x0b, 0x04, 0x04, 0x81, 0x24, 0x84, 0x01, 0x04, 0x04, 0x00, 0x80, 0x40, 0x40, 0x84, 0x0c,
+    0x20, 0x21, 0x41, 0x51, 0x51, 0x00, 0x01, 0x10, 0x18, 0x38, 0x08, 0x0c, 0x06, 0x81, 0x0b, 0x03,
+    0x00, 0x08, 0x08, 0x08, 0x0c, 0x02, 0x00, 0x02, 0x01, 0x04, 0x0a, 0x82, 0x02, 0x80, 0x00, 0x80,
+    0x8a, 0x05, 0xc0, 0xe0, 0x60, 0x60, 0x60, 0xc0, 0x91, 0x95, 0x00, 0x06, 0x82, 0x04, 0x01, 0x81,
+    0x01, 0x10, 0x01, 0x86, 0x02, 0x02, 0x02, 0x03, 0x82, 0x05, 0x05, 0x05, 0x02, 0x04, 0x05, 0x02,
+    0x81, 0x03, 0x01, 0x02, 0x02, 0x03, 0x84, 0x03, 0x03, 0x03, 0x02, 0x02, 0x81, 0x02, 0x02, 0x02,
+    0x03, 0x94, 0x13, 0x01, 0x04, 0x12, 0xc8, 0x20, 0x40, 0x40, 0xe0, 0xa0, 0x90, 0x08, 0x00, 0x21,
+    0x45, 0x04, 0x08, 0x18, 0x40, 0x30, 0x0f, 0x90, 0x99, 0x02, 0xe0, 0x00, 0xfc, 0xc1, 0x0b, 0xfe,
+    0xc0, 0xc1, 0x66, 0x28, 0x38, 0x15, 0x1e, 0x08, 0x04, 0x02, 0x01, 0x94,
+    // back to frame 0
+    0x0f, 0x9f, 0x0a, 0x80, 0x20, 0x40, 0x20, 0x14, 0x0a, 0x02, 0x0a, 0x14, 0x00, 0x90, 0x86, 0x07,
+    0x40, 0x90, 0x68, 0x14, 0x0a, 0x06, 0x06, 0x02, 0x83, 0x06, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x83, 0x01, 0x80, 0x80, 0x81, 0x02, 0x40, 0x40, 0x40, 0x81, 0x00, 0x80, 0xac, 0x95, 0x01,
+    0x60, 0x40, 0x82, 0x06, 0x40, 0x20, 0x20, 0x18, 0x22, 0x08, 0x01, 0x82, 0x02, 0x80, 0x40, 0x40,
+    0x82, 0x0b, 0x04, 0x04, 0x81, 0x24, 0x84, 0x01, 0x04, 0x04, 0x00, 0x80, 0x40, 0x40, 0x84, 0x0c,
+    0x20, 0x21, 0x41, 0x51, 0x51, 0x00, 0x01, 0x10, 0x18, 0x38, 0x08, 0x0c, 0x06, 0x81, 0x0b, 0x03,
+    0x00, 0x08, 0x08, 0x08, 0x0c, 0x02, 0x00, 0x02, 0x01, 0x04, 0x0a, 0x82, 0x02, 0x80, 0x00, 0x80,
+    0x8a, 0x05, 0xc0, 0xe0, 0x60, 0x60, 0x60, 0xc0, 0x91, 0x95, 0x00, 0x06, 0x82, 0x04, 0x01, 0x81,
+    0x01, 0x10, 0x01, 0x86, 0x02, 0x02, 0x02, 0x03, 0x82, 0x05, 0x05, 0x05, 0x02, 0x04, 0x05, 0x02,
+    0x81, 0x03, 0x01, 0x02, 0x02, 0x03, 0x84, 0x03, 0x03, 0x03, 0x02, 0x02, 0x81, 0x02, 0x02, 0x02,
+    0x03, 0x94, 0x13, 0x01, 0x04, 0x12, 0xc8, 0x20, 0x40, 0x40, 0xe0, 0xa0, 0x90, 0x08, 0x00, 0x21,
+    0x45, 0x04, 0x08, 0x18, 0x40, 0x30, 0x0f, 0x90, 0x99, 0x02, 0xe0, 0x00, 0xfc, 0xc1, 0x0b, 0xfe,
+    0xc0, 0xc1, 0x66, 0x28, 0x38, 0x15, 0x1e, 0x08, 0x04, 0x02, 0x01, 0x94,
+};
+
+#endif // pusheen_anim_h_INCLUDED
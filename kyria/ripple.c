@@ -1,135 +1,1060 @@
 #ifdef OLED_ENABLE
 #include "ripple.h"
 
+#include <string.h>
+
 #ifndef QMK_EMULATOR
 #include "print.h"
 #endif
 
-/* maximum number of ripples */
-#define RIPPLE_MAX 15
-/* time between frames in ms */
-#define RIPPLE_FRAMETIME 100
-/* period of the ripple in ms */
-#define RIPPLE_PERIOD 1500
-/* wavelength of the ripple in px */
-#define RIPPLE_WAVELENGTH 15
-/* time before ripple ceases */
-#define RIPPLE_TIMEOUT 5000
-/* ripple scroll speed x */
-#define RIPPLE_SCROLL_X 0
-/* ripple scroll speed y */
-#define RIPPLE_SCROLL_Y 0
-
-typedef struct ripple ripple_t;
-
-struct ripple {
-    uint8_t x;
-    uint8_t y;
-    int8_t x_scroll;
-    int8_t y_scroll;
-    uint8_t wavelength;
-    uint16_t period;
-    uint16_t start;
-    uint16_t timeout;
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+/*
+ * the timing model divides by RIPPLE_PERIOD and RIPPLE_TIMEOUT every
+ * frame. x / d is computed as (x * ceil(2^s / d)) >> s instead, which
+ * is exact for all x with x * d < 2^s. elapsed never exceeds
+ * RIPPLE_TIMEOUT, and the products must stay within 32 bits.
+ */
+#define RECIP(d, s) ((uint32_t)((((uint64_t)1 << (s)) + (d) - 1) / (d)))
+
+/* x / RIPPLE_PERIOD for x < 2^26 / RIPPLE_PERIOD */
+#define PERIOD_SHIFT 26
+#define PERIOD_RECIP RECIP(RIPPLE_PERIOD, PERIOD_SHIFT)
+
+/* x * 100 / RIPPLE_TIMEOUT for x < 2^25 / RIPPLE_TIMEOUT */
+#define FADE_SHIFT 25
+#define FADE_RECIP ((uint32_t)(((100ULL << FADE_SHIFT) + RIPPLE_TIMEOUT - 1) / RIPPLE_TIMEOUT))
+
+/*
+ * period_div takes an age, up to RIPPLE_TIMEOUT, or a phase times the
+ * wavelength, under RIPPLE_PERIOD * RIPPLE_WAVELENGTH. the fade takes
+ * an age.
+ */
+#if RIPPLE_PERIOD < 1 || RIPPLE_TIMEOUT < 1 || RIPPLE_WAVELENGTH < 1
+#error "RIPPLE_PERIOD, RIPPLE_TIMEOUT and RIPPLE_WAVELENGTH must be at least 1"
+#endif
+#if RIPPLE_TIMEOUT > 0x7fff
+#error "RIPPLE_TIMEOUT must stay within half the timer's wrap"
+#endif
+#if (RIPPLE_TIMEOUT + 0LL) * RIPPLE_PERIOD >= (1LL << PERIOD_SHIFT) \
+    || (RIPPLE_PERIOD + 0LL) * RIPPLE_PERIOD * RIPPLE_WAVELENGTH >= (1LL << PERIOD_SHIFT)
+#error "RIPPLE_PERIOD is too long for RIPPLE_TIMEOUT or RIPPLE_WAVELENGTH, period_div would be off"
+#endif
+#if (RIPPLE_TIMEOUT + 0LL) * RIPPLE_TIMEOUT >= (1LL << FADE_SHIFT)
+#error "RIPPLE_TIMEOUT is too long for the fade's fixed point"
+#endif
+
+/* rings alive once the ripple stops creating new inner rings */
+#define RIPPLE_RINGS ((RIPPLE_TIMEOUT / 2 + RIPPLE_PERIOD - 1) / RIPPLE_PERIOD)
+
+#if RIPPLE_RING_CAP < 1 || RIPPLE_RING_CAP > 255
+#error "RIPPLE_RING_CAP must be 1 to 255"
+#endif
+
+typedef ripple_span_t span_t;
+
+typedef struct plan plan_t;
+
+/* the rings of a live ripple to draw this frame */
+struct plan {
+    uint16_t age;
+    /* radius of the innermost ring */
+    uint16_t radius;
+    uint8_t count;
 };
 
-static uint8_t rippndx = 0;
-static ripple_t ripples[RIPPLE_MAX];
+#define SPAN_EMPTY ((span_t){ .lo = OLED_DISPLAY_WIDTH, .hi = 0 })
+
+#ifdef RIPPLE_SYNC_ENABLE
+/*
+ * an event is 3 bytes, little endian: x in bits 0-6, y in bits 7-12
+ * and how many ms ago the ripple started in bits 13-23, so the halves
+ * don't need clocks in step. a batch is a count byte and its events.
+ */
+#define SYNC_EVENT 3
+#define SYNC_AGE_MAX 0x7ff
+
+#if OLED_DISPLAY_WIDTH > 128 || OLED_DISPLAY_HEIGHT > 64
+#error "ripple sync events only fit a 128x64 display"
+#endif
+
+#endif
+
+#ifdef QMK_EMULATOR
+uint8_t ripple_render = RIPPLE_RENDER;
+uint16_t ripple_stats_interval = RIPPLE_STATS_INTERVAL;
+uint16_t ripple_merge_age = RIPPLE_MERGE_AGE;
+
+const char *const ripple_render_names[RIPPLE_RENDER_COUNT] = {
+    [RIPPLE_RENDER_PIXEL] = "pixel",
+    [RIPPLE_RENDER_BYTES] = "bytes",
+    [RIPPLE_RENDER_ATLAS] = "atlas",
+};
+
+#define RENDER ripple_render
+#define STATS_INTERVAL ripple_stats_interval
+#define MERGE_AGE ripple_merge_age
+#else
+#define RENDER RIPPLE_RENDER
+#define STATS_INTERVAL RIPPLE_STATS_INTERVAL
+#define MERGE_AGE RIPPLE_MERGE_AGE
+#endif
+
+#ifdef RIPPLE_STATS
+#define STAT(c, name, n) ((c)->stats.name += (n))
+#else
+#define STAT(c, name, n) ((void)(c))
+#endif
+
+#if defined(RIPPLE_STATS) && defined(QMK_EMULATOR)
+#include "emu/emu.h"
+#endif
+
+static uint16_t timer_clock(ripple_ctx_t *c)
+{
+    (void)c;
+
+    return timer_read();
+}
+
+#ifdef RIPPLE_FRAME
+static uint8_t frame[OLED_MATRIX_SIZE];
+#define FRAME frame
+#else
+#define FRAME NULL
+#endif
+
+/* the keyboard's engine, drawing into ripple_layer */
+static ripple_ctx_t ripple_default = {
+    .clock = timer_clock,
+    .layer = &ripple_layer,
+    .frame = FRAME,
+    .sched = { .frametime = RIPPLE_FRAMETIME },
+    .seed = 1,
+};
+
+comp_layer_t ripple_layer = {
+    .name = "ripples",
+    .buf = FRAME,
+    .width = OLED_DISPLAY_WIDTH,
+    .pages = RIPPLE_PAGES,
+    .blend = COMP_OR,
+    .update = oled_write_ripples,
+};
+
+static inline uint16_t now(ripple_ctx_t *c)
+{
+    return c->clock(c);
+}
+
+static inline uint16_t elapsed(ripple_ctx_t *c, uint16_t since)
+{
+    return now(c) - since;
+}
+
+#ifndef RIPPLE_FADE_NOISE
+/*
+ * 8x8 bayer matrix, a pixel at (x, y) is dropped while
+ * bayer[y % 8][x % 8] is below the fade level
+ */
+static const uint8_t PROGMEM bayer[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+#endif
+
+/*
+ * xorshift16 (7, 9, 8), a few shifts instead of a call into libc
+ */
+static inline uint16_t rng(ripple_ctx_t *c)
+{
+    STAT(c, rngs, 1);
+
+    c->seed ^= c->seed << 7;
+    c->seed ^= c->seed >> 9;
+    c->seed ^= c->seed << 8;
+
+    return c->seed;
+}
+
+/*
+ * set the fade for the rings drawn next, in percent of pixels dropped.
+ * with the ordered dither, pages line up with the 8 rows of the bayer
+ * matrix, so the fade is one mask per column and costs an and per byte.
+ */
+static void setfade(ripple_ctx_t *c, uint8_t pct)
+{
+#ifdef RIPPLE_FADE_NOISE
+    c->dapple = pct;
+#else
+    uint8_t level;
+
+    level = (pct * 64 + 99) / 100;
+
+    for (uint8_t x = 0; x < 8; x++) {
+        c->fade[x] = 0;
+
+        for (uint8_t y = 0; y < 8; y++) {
+            if (pgm_read_byte(&bayer[y][x]) >= level) {
+                c->fade[x] |= 1 << y;
+            }
+        }
+    }
+#endif
+}
+
+/*
+ * or bits into column x of a page, x must be on screen
+ */
+static inline void putbits(ripple_ctx_t *c, uint8_t x, uint8_t page, uint8_t bits)
+{
+    span_t *s;
+    uint16_t i;
+
+#ifndef RIPPLE_FADE_NOISE
+    bits &= c->fade[x % 8];
+    if (!bits) {
+        return;
+    }
+#endif
+
+    STAT(c, writes, 1);
+    STAT(c, pixels, __builtin_popcount(bits));
+
+    i = page * OLED_DISPLAY_WIDTH + x;
+    if (c->frame) {
+        c->frame[i] |= bits;
+    } else if (!comp_hidden(page, x)) {
+        oled_write_raw_byte(oled_read_raw(i).current_element[0] | bits, i);
+    }
+
+    s = &c->drawn[page];
+    if (x < s->lo) {
+        s->lo = x;
+    }
+    if (x >= s->hi) {
+        s->hi = x + 1;
+    }
+}
+
+/*
+ * a pixel known to be on the display
+ */
+static inline void dot(ripple_ctx_t *c, int x, int y)
+{
+    putbits(c, x, (uint8_t)y / 8, 1 << ((uint8_t)y % 8));
+}
+
+static inline void pixel(ripple_ctx_t *c, int x, int y)
+{
+    if (x < 0 || x >= OLED_DISPLAY_WIDTH) {
+        STAT(c, clipped, 1);
+        return;
+    }
+
+    if (y < 0 || y >= OLED_DISPLAY_HEIGHT) {
+        STAT(c, clipped, 1);
+        return;
+    }
+
+    dot(c, x, y);
+}
+
+/*
+ * blank what the last frame drew, before drawing the next
+ */
+static void clearframe(ripple_ctx_t *c)
+{
+    span_t *s;
+    uint16_t base;
+
+    for (uint8_t page = 0; page < RIPPLE_PAGES; page++) {
+        s = &c->shown[page];
+        base = page * OLED_DISPLAY_WIDTH;
+
+        if (s->lo >= s->hi) {
+            continue;
+        } else if (c->frame) {
+            memset(&c->frame[base + s->lo], 0, s->hi - s->lo);
+        } else {
+            for (uint8_t x = s->lo; x < s->hi; x++) {
+                if (!comp_hidden(page, x)) {
+                    oled_write_raw_byte(0, base + x);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * hand the frame to the compositor, if there is one: what was drawn
+ * now, and what was drawn last time and has been cleared since
+ */
+static void flushframe(ripple_ctx_t *c)
+{
+    for (uint8_t page = 0; page < RIPPLE_PAGES; page++) {
+        if (c->layer) {
+            comp_dirty(c->layer, page,
+                MIN(c->drawn[page].lo, c->shown[page].lo),
+                MAX(c->drawn[page].hi, c->shown[page].hi));
+        }
+
+        c->shown[page] = c->drawn[page];
+        c->drawn[page] = SPAN_EMPTY;
+    }
+}
+
+static inline void putquads(ripple_ctx_t *c, int xc, int yc, int x, int y)
+{
+#ifdef RIPPLE_FADE_NOISE
+    if ((rng(c) % 100) < c->dapple) {
+        return;
+    }
+#endif
+
+    pixel(c, xc+x, yc+y);
+    pixel(c, xc-x, yc+y);
+    pixel(c, xc+x, yc-y);
+    pixel(c, xc-x, yc-y);
+    pixel(c, xc+y, yc+x);
+    pixel(c, xc-y, yc+x);
+    pixel(c, xc+y, yc-x);
+    pixel(c, xc-y, yc-x);
+}
+
+/*
+ * bresenham’s circle drawing algorithm, checking every pixel. it is
+ * the reference the other rasterizers are checked against, so it
+ * draws every ring whole rather than culling or clipping it.
+ */
+static void putcircle(ripple_ctx_t *c, int xc, int yc, int r)
+{
+    int x, y, d;
+
+    x = 0;
+    y = r;
+
+    d = 3 - 2 * r;
+
+    while (y >= x) {
+        STAT(c, steps, 1);
+
+        putquads(c, xc, yc, x, y);
+        x++;
+
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+typedef struct row row_t;
+
+/* a display row as a page and the bit of it within that page */
+struct row {
+    int8_t page;
+    uint8_t bit;
+};
+
+static inline row_t rowat(int y)
+{
+    /* floor division, the side rows step once past the ring's top */
+    return (row_t){
+        .page = ((y + 256) >> 3) - 32,
+        .bit = 1 << ((y + 256) & 7),
+    };
+}
+
+static inline void rowdown(row_t *row)
+{
+    row->bit <<= 1;
+    if (!row->bit) {
+        row->bit = 0x01;
+        row->page++;
+    }
+}
+
+static inline void rowup(row_t *row)
+{
+    row->bit >>= 1;
+    if (!row->bit) {
+        row->bit = 0x80;
+        row->page--;
+    }
+}
+
+/*
+ * or a gathered byte into a column known to be on the display
+ */
+static inline void putbyte(ripple_ctx_t *c, int x, int8_t page, uint8_t bits)
+{
+    if (bits) {
+        putbits(c, x, page, bits);
+    }
+}
+
+/*
+ * the same walk as putcircle, writing page bytes instead of pixels.
+ * every octant's row moves by at most one pixel per step, so its bit
+ * is shifted along instead of recomputed. in the four side octants
+ * the row moves every step while the column rarely does, so their
+ * points are gathered into one byte per column and page before it is
+ * written. only for rings inside the display, which need no checks.
+ */
+static void rastercircle(ripple_ctx_t *c, int xc, int yc, int r)
+{
+    int x, y, d;
+    /* rows yc + y and yc - y of the top and bottom octants */
+    row_t bottom, top;
+    /* rows yc + x and yc - x of the side octants */
+    row_t down, up;
+    /* side octant bits gathered for columns xc + y and xc - y */
+    uint8_t right_down, right_up, left_down, left_up;
+
+    x = 0;
+    y = r;
+
+    d = 3 - 2 * r;
+
+    bottom = rowat(yc + r);
+    top = rowat(yc - r);
+    down = rowat(yc);
+    up = down;
+
+    right_down = right_up = left_down = left_up = 0;
+
+    while (y >= x) {
+        STAT(c, steps, 1);
+
+#ifdef RIPPLE_FADE_NOISE
+        if ((rng(c) % 100) >= c->dapple)
+#endif
+        {
+            putbyte(c, xc + x, bottom.page, bottom.bit);
+            putbyte(c, xc - x, bottom.page, bottom.bit);
+            putbyte(c, xc + x, top.page, top.bit);
+            putbyte(c, xc - x, top.page, top.bit);
+
+            right_down |= down.bit;
+            left_down |= down.bit;
+            right_up |= up.bit;
+            left_up |= up.bit;
+        }
+
+        x++;
+
+        if (d > 0) {
+            /* the side columns move, write what they gathered */
+            putbyte(c, xc + y, down.page, right_down);
+            putbyte(c, xc - y, down.page, left_down);
+            putbyte(c, xc + y, up.page, right_up);
+            putbyte(c, xc - y, up.page, left_up);
+            right_down = right_up = left_down = left_up = 0;
+
+            y--;
+            rowup(&bottom);
+            rowdown(&top);
+
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+
+        /* the side rows leave their page, write what they gathered */
+        if (down.bit == 0x80) {
+            putbyte(c, xc + y, down.page, right_down);
+            putbyte(c, xc - y, down.page, left_down);
+            right_down = left_down = 0;
+        }
+
+        if (up.bit == 0x01) {
+            putbyte(c, xc + y, up.page, right_up);
+            putbyte(c, xc - y, up.page, left_up);
+            right_up = left_up = 0;
+        }
+
+        rowdown(&down);
+        rowup(&up);
+    }
+
+    putbyte(c, xc + y, down.page, right_down);
+    putbyte(c, xc - y, down.page, left_down);
+    putbyte(c, xc + y, up.page, right_up);
+    putbyte(c, xc - y, up.page, left_up);
+}
+
+/*
+ * true when no point of a ring can be on the display: the display is
+ * all outside it, or all inside its hole. the rasterized ring strays
+ * less than a pixel from the true circle.
+ */
+static bool offscreen(int xc, int yc, int r)
+{
+    int32_t nx, ny, fx, fy;
+
+    /* nearest and farthest point of the display from the centre */
+    nx = xc < 0 ? -xc : xc >= OLED_DISPLAY_WIDTH ? xc - (OLED_DISPLAY_WIDTH - 1) : 0;
+    ny = yc < 0 ? -yc : yc >= OLED_DISPLAY_HEIGHT ? yc - (OLED_DISPLAY_HEIGHT - 1) : 0;
+
+    /* a centre on the display is over half its height from a corner */
+    if (!nx && !ny && r <= OLED_DISPLAY_HEIGHT / 2) {
+        return false;
+    }
+
+    fx = MAX(xc, OLED_DISPLAY_WIDTH - 1 - xc);
+    fy = MAX(yc, OLED_DISPLAY_HEIGHT - 1 - yc);
+
+    return nx * nx + ny * ny > (int32_t)(r + 1) * (r + 1)
+        || fx * fx + fy * fy < (int32_t)(r - 1) * (r - 1);
+}
+
+typedef struct octant octant_t;
+
+/*
+ * the steps of a bresenham walk that can put an octant's points on
+ * the display. a walk steps x from 0 while y falls from r to about
+ * r / sqrt(2), so every octant has one coordinate that is c +/- x,
+ * which is on the display for a range of steps, and one that is
+ * c +/- y, which stays in a range known before the walk.
+ */
+struct octant {
+    /* steps [lo, hi) with the x coordinate on the display */
+    int16_t lo;
+    int16_t hi;
+    /* whether the y coordinate can be off the display, and needs checking */
+    bool check;
+};
+
+/*
+ * steps x >= 0 that put base + sign * x in [0, size)
+ */
+static inline void steprange(octant_t *o, int base, int8_t sign, int size)
+{
+    if (sign > 0) {
+        o->lo = MAX(0, -base);
+        o->hi = size - base;
+    } else {
+        o->lo = MAX(0, base - size + 1);
+        o->hi = base + 1;
+    }
+}
+
+/*
+ * where base + sign * y lands for y in [ymin, r]: all inside [0, size)
+ * needs no checks, all outside empties the octant
+ */
+static inline void yrange(octant_t *o, int base, int8_t sign, int size, int ymin, int r)
+{
+    int lo, hi;
+
+    lo = sign > 0 ? base + ymin : base - r;
+    hi = sign > 0 ? base + r : base - ymin;
+
+    if (hi < 0 || lo >= size) {
+        o->hi = o->lo;
+    }
+
+    o->check = lo < 0 || hi >= size;
+}
+
+/*
+ * clip the octants of a ring and return the step after which none of
+ * them is on the display. octant i is the point
+ *
+ *     (xc +/- x, yc +/- y) for i < 4, or (xc +/- y, yc +/- x)
+ *
+ * with x negated when bit 0 of i is set and y when bit 1 is.
+ */
+static int16_t clipring(octant_t o[8], int xc, int yc, int r)
+{
+    int16_t end;
+    int ymin;
+
+    /* y ends the walk above r / sqrt(2) - 1, 181 / 256 is just under */
+    ymin = MAX(0, r * 181 / 256 - 1);
+
+    end = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        int8_t sx = i & 1 ? -1 : 1;
+        int8_t sy = i & 2 ? -1 : 1;
+
+        if (i < 4) {
+            steprange(&o[i], xc, sx, OLED_DISPLAY_WIDTH);
+            yrange(&o[i], yc, sy, OLED_DISPLAY_HEIGHT, ymin, r);
+        } else {
+            steprange(&o[i], yc, sy, OLED_DISPLAY_HEIGHT);
+            yrange(&o[i], xc, sx, OLED_DISPLAY_WIDTH, ymin, r);
+        }
+
+        if (o[i].hi > o[i].lo) {
+            end = MAX(end, o[i].hi);
+        }
+    }
+
+    return end;
+}
+
+/*
+ * largest ring a ripple draws: the outermost ring is never more than
+ * a wavelength per period it has been alive
+ */
+#define RADIUS_MAX (RIPPLE_WAVELENGTH * (RIPPLE_TIMEOUT / RIPPLE_PERIOD + 1))
+
+/* steps in a walk of RADIUS_MAX, a little over r / sqrt(2) */
+#define WALK_MAX (RADIUS_MAX * 3 / 4 + 2)
+
+/* a walk keeps its ys in bytes, and stops at WALK_MAX steps */
+#if RADIUS_MAX > 255
+#error "RIPPLE_WAVELENGTH * (RIPPLE_TIMEOUT / RIPPLE_PERIOD + 1) must be at most 255 px"
+#endif
+
+/* y of a step the noise fade dropped, no step is dropped without it */
+#define DROPPED 0xff
+#ifdef RIPPLE_FADE_NOISE
+#define KEPT(y) ((y) != DROPPED)
+#else
+#define KEPT(y) true
+#endif
+
+/*
+ * bresenham’s circle drawing algorithm, recording y for each step x
+ * up to end. returns the number of steps.
+ */
+static int16_t walk(ripple_ctx_t *c, uint8_t ys[WALK_MAX], int r, int16_t end)
+{
+    int x, y, d;
+
+    x = 0;
+    y = r;
+
+    d = 3 - 2 * r;
+
+    end = MIN(end, WALK_MAX);
+
+    while (y >= x && x < end) {
+        STAT(c, steps, 1);
+
+        ys[x] = y;
+
+#ifdef RIPPLE_FADE_NOISE
+        /* all eight points of a step go together */
+        if ((rng(c) % 100) < c->dapple) {
+            ys[x] = DROPPED;
+        }
+#endif
+
+        x++;
+
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+
+    return x;
+}
 
-static inline void pixel(int x, int y)
+static inline void putpage(ripple_ctx_t *c, int x, int8_t page, uint8_t bits)
 {
-    if (x < 0 || x > UINT8_MAX) {
+    if (!bits) {
         return;
     }
 
-    if (y < 0 || y > UINT8_MAX) {
+    if (x < 0 || x >= OLED_DISPLAY_WIDTH || page < 0 || page >= RIPPLE_PAGES) {
+        STAT(c, clipped, __builtin_popcount(bits));
         return;
     }
 
-    oled_write_pixel((uint8_t)x, (uint8_t)y, true);
+    putbits(c, x, page, bits);
+}
+
+/*
+ * rastercircle for a ring that crosses an edge of the display: walk
+ * it once, then draw each octant over only the steps that can put it
+ * on the display. only octants that can leave the display sideways
+ * check their points. the side octants are gathered into page bytes
+ * like rastercircle does, the top and bottom ones go a bit at a time.
+ */
+static void clipcircle(ripple_ctx_t *c, int xc, int yc, int r)
+{
+    uint8_t ys[WALK_MAX];
+    octant_t o[8];
+    int16_t steps;
+    int16_t end;
+    /* the side octant byte being gathered */
+    int col;
+    int8_t page;
+    uint8_t bits;
+    int px, py;
+
+    steps = walk(c, ys, r, clipring(o, xc, yc, r));
+
+    for (uint8_t i = 0; i < 8; i++) {
+        int8_t sx = i & 1 ? -1 : 1;
+        int8_t sy = i & 2 ? -1 : 1;
+
+        end = MIN(o[i].hi, steps);
+
+        if (i < 4) {
+            for (int x = o[i].lo; x < end; x++) {
+                if (!KEPT(ys[x])) {
+                    continue;
+                }
+
+                if (o[i].check) {
+                    pixel(c, xc + sx * x, yc + sy * ys[x]);
+                } else {
+                    dot(c, xc + sx * x, yc + sy * ys[x]);
+                }
+            }
+            continue;
+        }
+
+        /* the row is on the display for every step in range */
+        col = 0;
+        page = 0;
+        bits = 0;
+
+        for (int x = o[i].lo; x < end; x++) {
+            if (!KEPT(ys[x])) {
+                continue;
+            }
+
+            px = xc + sx * ys[x];
+            py = yc + sy * x;
+
+            if (px != col || py / 8 != page) {
+                if (o[i].check) {
+                    putpage(c, col, page, bits);
+                } else {
+                    putbyte(c, col, page, bits);
+                }
+
+                col = px;
+                page = py / 8;
+                bits = 0;
+            }
+
+            bits |= 1 << (py % 8);
+        }
+
+        if (o[i].check) {
+            putpage(c, col, page, bits);
+        } else {
+            putbyte(c, col, page, bits);
+        }
+    }
+}
+
+#ifdef RIPPLE_ATLAS
+#include "ripple_atlas.h"
+
+#ifdef RIPPLE_STATS
+/* pixels of a strip that miss column x, lo and hi being what is on screen */
+static inline uint8_t stripclip(int x, uint8_t bits, uint8_t lo, uint8_t hi)
+{
+    if (x < 0 || x >= OLED_DISPLAY_WIDTH) {
+        return __builtin_popcount(bits);
+    }
+
+    return __builtin_popcount(bits) - __builtin_popcount(lo) - __builtin_popcount(hi);
 }
+#endif
 
-static inline void putquads(int xc, int yc, int x, int y, int dapple)
+/*
+ * or a vertical strip of 8 pixels, bit 0 at row y, into columns x0
+ * and x1. the strip straddles two pages unless y is page aligned.
+ */
+static inline void putstrip(ripple_ctx_t *c, int x0, int x1, int y, uint8_t bits)
 {
-    uint8_t pct;
+    int page;
+    uint8_t shift;
+    uint8_t lo;
+    uint8_t hi;
 
-    pct = rand() % 100;
-    if (pct < dapple) {
+    if (y <= -8 || y >= OLED_DISPLAY_HEIGHT) {
+        STAT(c, clipped, __builtin_popcount(bits) * (1 + (x1 != x0)));
         return;
     }
 
-    pixel(xc+x, yc+y);
-    pixel(xc-x, yc+y);
-    pixel(xc+x, yc-y);
-    pixel(xc-x, yc-y);
-    pixel(xc+y, yc+x);
-    pixel(xc-y, yc+x);
-    pixel(xc+y, yc-x);
-    pixel(xc-y, yc-x);
+    /* floor division, y may be as low as -7 */
+    page = (y + 8) / 8 - 1;
+    shift = (y + 8) % 8;
+
+    lo = page >= 0 ? bits << shift : 0;
+    hi = shift && page + 1 < RIPPLE_PAGES ? bits >> (8 - shift) : 0;
+
+    STAT(c, clipped, stripclip(x0, bits, lo, hi) + (x1 != x0 ? stripclip(x1, bits, lo, hi) : 0));
+
+    if (x0 >= 0 && x0 < OLED_DISPLAY_WIDTH) {
+        if (lo) {
+            putbits(c, x0, page, lo);
+        }
+        if (hi) {
+            putbits(c, x0, page + 1, hi);
+        }
+    }
+
+    if (x1 != x0 && x1 >= 0 && x1 < OLED_DISPLAY_WIDTH) {
+        if (lo) {
+            putbits(c, x1, page, lo);
+        }
+        if (hi) {
+            putbits(c, x1, page + 1, hi);
+        }
+    }
+}
+
+static inline uint8_t reverse(uint8_t bits)
+{
+    static const uint8_t PROGMEM nibble[16] = {
+        0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+        0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf,
+    };
+
+    return pgm_read_byte(&nibble[bits & 0xf]) << 4
+        | pgm_read_byte(&nibble[bits >> 4]);
 }
 
 /*
- * bresenham’s circle drawing algorithm
+ * draw a ring from its precomputed lower right quadrant, mirroring
+ * each byte into the other three quadrants. the lower half keeps the
+ * bit order, the upper half is flipped, so its bytes are reversed.
+ * the noise fade drops a whole quadrant column at a time, mirrored
+ * like the groups of eight pixels putquads drops.
  */
-static void putcircle(int xc, int yc, int r, int dapple)
+static void blitcircle(ripple_ctx_t *c, int xc, int yc, int r)
 {
-    int x, y, d;
+    const uint8_t *col;
+    octant_t left, right;
+    int16_t lo, hi;
+    uint8_t head;
+    uint8_t page;
+    uint8_t count;
+    uint8_t bits;
 
-    x = 0;
-    y = r;
+    /*
+     * columns xc - x and xc + x are both on the display from x = 0
+     * when xc is, and only one of them is when it isn't, so the x
+     * with either on the display are one range
+     */
+    steprange(&left, xc, -1, OLED_DISPLAY_WIDTH);
+    steprange(&right, xc, 1, OLED_DISPLAY_WIDTH);
+    lo = left.hi > left.lo ? left.lo : right.lo;
+    hi = MAX(left.hi, right.hi);
 
-    d = 3 - 2 * r;
+    col = &ripple_atlas[pgm_read_word(&ripple_atlas_index[r])];
 
-    while (y >= x) {
-        putquads(xc, yc, x, y, dapple);
-        x++;
+    for (int x = 0; x <= r && x < hi; x++) {
+        /* first page in the low nibble, page count in the high */
+        head = pgm_read_byte(col++);
+        page = head & 0xf;
+        count = head >> 4;
 
-        if (d > 0) {
-            y--;
-            d = d + 4 * (x - y) + 10;
-        } else {
-            d = d + 4 * x + 6;
+        if (x < lo) {
+            col += count;
+            continue;
+        }
+
+        STAT(c, steps, 1);
+
+#ifdef RIPPLE_FADE_NOISE
+        if ((rng(c) % 100) < c->dapple) {
+            col += count;
+            continue;
+        }
+#endif
+
+        for (; count; count--, page++, col++) {
+            bits = pgm_read_byte(col);
+
+            putstrip(c, xc - x, xc + x, yc + page * 8, bits);
+            putstrip(c, xc - x, xc + x, yc - page * 8 - 7, reverse(bits));
+        }
+    }
+}
+#endif
+
+/*
+ * true when every point of a ring is on the display
+ */
+static inline bool inside(int xc, int yc, int r)
+{
+    return xc >= r && xc + r < OLED_DISPLAY_WIDTH
+        && yc >= r && yc + r < OLED_DISPLAY_HEIGHT;
+}
+
+static inline void drawcircle(ripple_ctx_t *c, int xc, int yc, int r)
+{
+    if (RENDER != RIPPLE_RENDER_PIXEL && offscreen(xc, yc, r)) {
+        STAT(c, culled, 1);
+        return;
+    }
+
+    STAT(c, circles, 1);
+
+    switch (RENDER) {
+#ifdef RIPPLE_ATLAS
+        case RIPPLE_RENDER_ATLAS:
+            /* rings past the atlas are rasterized, the atlas clips its own columns */
+            if (r <= RIPPLE_ATLAS_RADIUS) {
+                blitcircle(c, xc, yc, r);
+                break;
+            }
+            if (inside(xc, yc, r)) {
+                rastercircle(c, xc, yc, r);
+            } else {
+                clipcircle(c, xc, yc, r);
+            }
+            break;
+#endif
+        case RIPPLE_RENDER_BYTES:
+            if (inside(xc, yc, r)) {
+                rastercircle(c, xc, yc, r);
+            } else {
+                clipcircle(c, xc, yc, r);
+            }
+            break;
+        default:
+            putcircle(c, xc, yc, r);
+            break;
+    }
+}
+
+/*
+ * whether a ripple starting at x, y is close enough to a young one to
+ * merge. a ripple past RIPPLE_TIMEOUT is gone even if no frame has
+ * dropped it from the pool yet.
+ */
+static bool merge(ripple_ctx_t *c, uint8_t x, uint8_t y, uint16_t start)
+{
+#if RIPPLE_MERGE_AGE || defined(QMK_EMULATOR)
+    ripple_t *r;
+
+    /* newest first, they're the likeliest to be young */
+    for (uint8_t i = c->alive; i-- > 0;) {
+        r = &c->ripples[c->order[i]];
+
+        if (elapsed(c, r->start) <= RIPPLE_TIMEOUT
+            && (uint16_t)(start - r->start) < MERGE_AGE
+            && (x > r->x ? x - r->x : r->x - x) <= RIPPLE_MERGE_DIST
+            && (y > r->y ? y - r->y : r->y - y) <= RIPPLE_MERGE_DIST) {
+            return true;
         }
     }
+#else
+    (void)c;
+    (void)x;
+    (void)y;
+    (void)start;
+#endif
+
+    return false;
 }
 
-static void addripple(int x, int y)
+static bool add(ripple_ctx_t *c, uint8_t x, uint8_t y, uint16_t start)
 {
-    ripples[rippndx] = (ripple_t){
+    uint8_t slot;
+    uint16_t age;
+    uint8_t i;
+
+    if (merge(c, x, y, start)) {
+        STAT(c, merged, 1);
+        return false;
+    }
+
+    if (c->spawned) {
+        c->spawned(x, y);
+    }
+
+    if (c->place_only) {
+        return true;
+    }
+
+    if (c->alive < RIPPLE_MAX) {
+        slot = c->order[c->alive++];
+    } else if (RIPPLE_EVICT == RIPPLE_EVICT_OLDEST) {
+        /* the oldest slot is reused as the newest */
+        slot = c->order[0];
+        memmove(&c->order[0], &c->order[1], RIPPLE_MAX - 1);
+        c->order[RIPPLE_MAX - 1] = slot;
+
+        STAT(c, evicted, 1);
+    } else {
+        STAT(c, dropped, 1);
+        return false;
+    }
+
+    /*
+     * the slot is last in order, but a ripple synced from the other
+     * half started a while ago, maybe before some of the live ones.
+     * it moves in among them by age, to keep them oldest first.
+     */
+    age = elapsed(c, start);
+    for (i = c->alive - 1; i > 0 && elapsed(c, c->ripples[c->order[i - 1]].start) < age; i--) {
+        c->order[i] = c->order[i - 1];
+    }
+    c->order[i] = slot;
+
+    c->ripples[slot] = (ripple_t){
         .x = x,
         .y = y,
         .x_scroll = RIPPLE_SCROLL_X,
         .y_scroll = RIPPLE_SCROLL_Y,
-        .wavelength = RIPPLE_WAVELENGTH,
-        .period = RIPPLE_PERIOD,
-        .start = timer_read(),
-        .timeout = RIPPLE_TIMEOUT,
+        .start = start,
     };
 
-    rippndx = (rippndx + 1) % RIPPLE_MAX;
+    return true;
+}
+
+bool ripple_ctx_add(ripple_ctx_t *c, uint8_t x, uint8_t y)
+{
+    return add(c, x, y, now(c));
 }
 
-static bool ripple(ripple_t *r)
+static inline uint16_t period_div(uint16_t x)
+{
+    return ((uint32_t)x * PERIOD_RECIP) >> PERIOD_SHIFT;
+}
+
+/* work out the rings a ripple has now, false once it has dissipated */
+static bool plan(ripple_ctx_t *c, ripple_t *r, plan_t *p)
 {
-    int dapple;
     uint16_t count;
+    uint16_t cycles;
+    uint16_t phase;
     uint16_t radius;
-    uint16_t elapsed;
-    uint16_t timeout;
-    float ratio;
-
-    timeout = r->timeout / 2;
+    uint16_t age;
 
     /* elapsed time for the ripple */
-    elapsed = timer_elapsed(r->start);
+    age = elapsed(c, r->start);
     /* check if the ripple has dissapated */
-    if (elapsed > r->timeout) {
-        r->start = 0;
+    if (age > RIPPLE_TIMEOUT) {
         return false;
     }
 
+    /* whole periods elapsed and time into the current one */
+    cycles = period_div(age);
+    phase = age - cycles * RIPPLE_PERIOD;
+
     /* the number of ripples */
-    count = (elapsed + (r->period - 1)) / r->period;
+    count = cycles + (phase != 0);
     /* the radius of the innermost ripple
      * v = freq * wavelength
      * v = 1/period * wavelength
@@ -138,83 +1063,402 @@ static bool ripple(ripple_t *r)
      * d = t * wavelength / period
      * let p = t / period
      * d = p * wavelength */
-    ratio = ((float)(elapsed % r->period)) / ((float)r->period);
-    radius = r->wavelength * ratio;
+    radius = period_div(phase * RIPPLE_WAVELENGTH);
 
     /* if we are past the timeout, stop creating inner circles */
-    if (elapsed > timeout) {
-        uint16_t max;
+    if (age > RIPPLE_TIMEOUT / 2) {
         uint16_t removed;
 
-        /* get max number of circles possible */
-        max = (timeout + (r->period - 1)) / r->period;
         /* this gives us number of circles to delete */
-        removed = count - max;
+        removed = count - RIPPLE_RINGS;
 
         count -= removed;
-        radius += r->wavelength * removed;
+        radius += RIPPLE_WAVELENGTH * removed;
     }
 
-    dapple = (((float)elapsed) / ((float)r->timeout)) * 100;
-    for (uint16_t i = 0; i < count; i++) {
-        putcircle(r->x, r->y, radius, dapple);
-        radius += r->wavelength;
-    }
+    p->age = age;
+    p->radius = radius;
+    p->count = count;
 
     return true;
 }
 
+/*
+ * bring the rings planned for the live ripples, oldest first, within
+ * cap. the oldest ripples are the most faded, so their outer rings go
+ * first, down to the innermost ring of every ripple, and then the
+ * oldest ripples themselves.
+ */
+static void thin(ripple_ctx_t *c, plan_t *plans, uint8_t n, uint16_t total, uint8_t cap)
+{
+    uint16_t drop;
+
+    if (total <= cap) {
+        return;
+    }
+
+    STAT(c, thinned, total - cap);
+
+    for (uint8_t i = 0; i < n && total > cap; i++) {
+        if (plans[i].count > 1) {
+            drop = MIN(plans[i].count - 1, total - cap);
+            plans[i].count -= drop;
+            total -= drop;
+        }
+    }
+
+    for (uint8_t i = 0; i < n && total > cap; i++) {
+        if (plans[i].count) {
+            plans[i].count = 0;
+            total--;
+        }
+    }
+}
+
+static void ripple(ripple_ctx_t *c, ripple_t *r, const plan_t *p)
+{
+    uint16_t radius;
+
+    if (!p->count) {
+        return;
+    }
+
+    radius = p->radius;
+
+    setfade(c, ((uint32_t)p->age * FADE_RECIP) >> FADE_SHIFT);
+    for (uint8_t i = 0; i < p->count; i++) {
+        drawcircle(c, r->x, r->y, radius);
+        radius += RIPPLE_WAVELENGTH;
+    }
+}
+
+void ripple_ctx_init(ripple_ctx_t *c, ripple_clock_t clock)
+{
+    c->clock = clock;
+    c->layer = NULL;
+    c->spawned = NULL;
+    c->place_only = false;
+
+    for (uint8_t i = 0; i < RIPPLE_MAX; i++) {
+        c->order[i] = i;
+    }
+    c->alive = 0;
+
+    c->sched = (ripple_sched_t){ .frametime = RIPPLE_FRAMETIME };
+
+#ifdef RIPPLE_SYNC_ENABLE
+    c->outbox_len = 0;
+#endif
+
+    /*
+     * the display is blank after oled_init, and so is the layer. an
+     * engine drawing into the display blanks what it showed there.
+     */
+    if (c->frame) {
+        memset(c->frame, 0, OLED_MATRIX_SIZE);
+    } else {
+        clearframe(c);
+    }
+    for (uint8_t page = 0; page < RIPPLE_PAGES; page++) {
+        c->drawn[page] = SPAN_EMPTY;
+        c->shown[page] = SPAN_EMPTY;
+    }
+
+    ripple_ctx_seed(c, now(c));
+
+    /* the first render after this draws a frame */
+    c->sched.last = now(c) - RIPPLE_FRAMETIME - 1;
+
+#ifdef RIPPLE_STATS
+    c->reported = now(c);
+#endif
+}
+
+void ripple_ctx_seed(ripple_ctx_t *c, uint16_t seed)
+{
+    /* xorshift never leaves 0 */
+    c->seed = seed ? seed : 1;
+}
+
+ripple_ctx_t *ripple_ctx(void)
+{
+    return &ripple_default;
+}
+
 void ripple_init(void)
 {
-    srand(timer_read());
+    ripple_ctx_init(&ripple_default, timer_clock);
+    ripple_default.layer = &ripple_layer;
+}
+
+bool ripple_add(uint8_t x, uint8_t y)
+{
+    return ripple_ctx_add(&ripple_default, x, y);
+}
+
+#ifdef RIPPLE_SYNC_ENABLE
+uint8_t ripple_sync_pack(uint8_t *buf, uint8_t size)
+{
+    ripple_ctx_t *c = &ripple_default;
+    uint32_t event;
+    uint16_t age;
+    uint8_t n;
+
+    if (!c->outbox_len || size < 1 + SYNC_EVENT) {
+        return 0;
+    }
+
+    n = MIN(c->outbox_len, (size - 1) / SYNC_EVENT);
+
+    buf[0] = n;
+    for (uint8_t i = 0; i < n; i++) {
+        age = MIN(elapsed(c, c->outbox[i].start), SYNC_AGE_MAX);
+        event = c->outbox[i].x | (uint32_t)c->outbox[i].y << 7 | (uint32_t)age << 13;
+
+        buf[1 + i * SYNC_EVENT] = event;
+        buf[2 + i * SYNC_EVENT] = event >> 8;
+        buf[3 + i * SYNC_EVENT] = event >> 16;
+    }
+
+    /* whatever didn't fit goes in the next batch */
+    c->outbox_len -= n;
+    memmove(&c->outbox[0], &c->outbox[n], c->outbox_len * sizeof(*c->outbox));
+
+    return 1 + n * SYNC_EVENT;
+}
+
+void ripple_sync_unpack(const uint8_t *buf, uint8_t len)
+{
+    ripple_ctx_t *c = &ripple_default;
+    uint32_t event;
+    uint16_t t;
+
+    if (!len || len < 1 + buf[0] * SYNC_EVENT) {
+        return;
+    }
+
+    t = now(c);
+    for (uint8_t i = 0; i < buf[0]; i++) {
+        event = buf[1 + i * SYNC_EVENT]
+            | (uint32_t)buf[2 + i * SYNC_EVENT] << 8
+            | (uint32_t)buf[3 + i * SYNC_EVENT] << 16;
+
+        add(c, event & 0x7f, (event >> 7) & 0x3f, t - (event >> 13));
+    }
 }
 
 void process_record_ripples(keyrecord_t *record)
 {
+    ripple_ctx_t *c = &ripple_default;
+    uint8_t x, y;
+
+    if (!record->event.pressed || !is_keyboard_master()) {
+        return;
+    }
+
+    x = rng(c) % OLED_DISPLAY_WIDTH;
+    y = rng(c) % OLED_DISPLAY_HEIGHT;
+
+    ripple_ctx_add(c, x, y);
+
+    if (c->outbox_len < RIPPLE_SYNC_BATCH) {
+        c->outbox[c->outbox_len++] = (ripple_pending_t){
+            .x = x,
+            .y = y,
+            .start = now(c),
+        };
+    } else {
+        STAT(c, unsent, 1);
+    }
+}
+#else
+void process_record_ripples(keyrecord_t *record)
+{
+    ripple_ctx_t *c = &ripple_default;
     bool is_master_press;
 
     if (record->event.pressed) {
         is_master_press = record->event.key.row < (MATRIX_ROWS / 2);
         if (is_master_press == is_keyboard_master()) {
-            addripple(
-                rand() % OLED_DISPLAY_WIDTH,
-                rand() % OLED_DISPLAY_HEIGHT
+            ripple_ctx_add(c,
+                rng(c) % OLED_DISPLAY_WIDTH,
+                rng(c) % OLED_DISPLAY_HEIGHT
             );
         }
     }
 }
+#endif
 
-void oled_write_ripples(void)
+/*
+ * adapt the frame rate and detail to what the last frame cost
+ */
+static void schedule(ripple_ctx_t *c, uint16_t cost)
 {
-    static uint16_t key_timer;
-    static bool clear = true;
+    ripple_sched_t *s = &c->sched;
+    uint16_t frametime;
+    uint8_t cap;
 
-    int count;
+    frametime = s->frametime;
+    cap = s->cap;
 
-    if (timer_elapsed(key_timer) > RIPPLE_FRAMETIME) {
-        key_timer = timer_read();
+    if (!c->alive) {
+        s->frametime = RIPPLE_FRAMETIME;
+        s->cap = 0;
+    } else if (cost > RIPPLE_BUDGET) {
+        s->overruns++;
 
-        if (!clear) {
-            oled_clear();
+        if (s->frametime < RIPPLE_FRAMETIME_MAX) {
+            s->frametime = MIN(s->frametime * 2, RIPPLE_FRAMETIME_MAX);
+        } else {
+            s->cap = MAX((s->cap ? s->cap : RIPPLE_RING_CAP) / 2, 1);
+        }
+    } else if (cost * 2 <= RIPPLE_BUDGET) {
+        if (s->cap) {
+            s->cap = s->cap * 2 < RIPPLE_RING_CAP ? s->cap * 2 : 0;
+        } else if (s->frametime > RIPPLE_FRAMETIME) {
+            s->frametime = MAX(s->frametime / 2, RIPPLE_FRAMETIME);
         }
+    }
 
-        count = 0;
-        for (size_t i = 0; i < RIPPLE_MAX; i++) {
-            if (ripples[i].start) {
-                count += ripple(&ripples[i]);
+#ifdef CONSOLE_ENABLE
+    /* only speak up about the keyboard's engine, when its rate or detail changes */
+    if (c == &ripple_default && (s->frametime != frametime || s->cap != cap)) {
+        uprintf("ripple: %u ms/frame, %u rings/frame, %u overruns\n",
+            s->frametime,
+            s->cap ? s->cap : RIPPLE_RING_CAP,
+            s->overruns);
 
-                ripples[i].x += ripples[i].x_scroll;
-                ripples[i].y += ripples[i].y_scroll;
-            }
-        }
+        s->overruns = 0;
+    }
+#else
+    (void)frametime;
+    (void)cap;
+#endif
+}
 
-        if (!count) {
-            oled_clear();
-            clear = true;
-        } else {
-            clear = false;
+#if defined(RIPPLE_STATS) && defined(CONSOLE_ENABLE)
+void ripple_stats_report(ripple_ctx_t *c)
+{
+    ripple_stats_t *s = &c->stats;
+    uint32_t frames;
+
+    c->reported = now(c);
+
+    /* per frame averages, in hundredths for the small ones */
+    frames = s->frames ? s->frames : 1;
+
+    uprintf("ripple: %lu frames, %lu.%02lu alive, %lu.%02lu circles, %lu steps, %lu px, %lu clipped, %lu.%02lu rng\n",
+        (unsigned long)s->frames,
+        (unsigned long)(s->alive / frames),
+        (unsigned long)(s->alive * 100 / frames % 100),
+        (unsigned long)(s->circles / frames),
+        (unsigned long)(s->circles * 100 / frames % 100),
+        (unsigned long)(s->steps / frames),
+        (unsigned long)(s->pixels / frames),
+        (unsigned long)(s->clipped / frames),
+        (unsigned long)(s->rngs / frames),
+        (unsigned long)(s->rngs * 100 / frames % 100));
+    uprintf("ripple: %lu us/frame, %lu max, %lu evicted, %lu dropped, %lu merged, %lu unsent, %lu.%02lu thinned\n",
+        (unsigned long)(s->frame_us / frames),
+        (unsigned long)s->frame_us_max,
+        (unsigned long)s->evicted,
+        (unsigned long)s->dropped,
+        (unsigned long)s->merged,
+        (unsigned long)s->unsent,
+        (unsigned long)(s->thinned / frames),
+        (unsigned long)(s->thinned * 100 / frames % 100));
+
+    *s = (ripple_stats_t){0};
+}
+#endif
+
+void ripple_ctx_render(ripple_ctx_t *c)
+{
+    plan_t plans[RIPPLE_MAX];
+    ripple_t *r;
+    uint8_t kept;
+    uint8_t slot;
+    uint16_t total;
+    uint16_t cost;
+#ifdef RIPPLE_STATS
+    uint32_t us;
+#endif
+#if defined(RIPPLE_STATS) && defined(QMK_EMULATOR)
+    uint64_t start;
+#endif
+
+    if (elapsed(c, c->sched.last) <= c->sched.frametime) {
+        return;
+    }
+
+    c->sched.last = now(c);
+#if defined(RIPPLE_STATS) && defined(QMK_EMULATOR)
+    start = emu_now();
+#endif
+
+    clearframe(c);
+
+    STAT(c, frames, 1);
+    STAT(c, alive, c->alive);
+
+    /*
+     * plan the live ripples, compacting the ones still alive to
+     * the front in order. a dead slot is swapped behind them, so
+     * it ends up in the free part once alive is cut short.
+     */
+    kept = 0;
+    total = 0;
+    for (uint8_t i = 0; i < c->alive; i++) {
+        if (!plan(c, &c->ripples[c->order[i]], &plans[kept])) {
+            continue;
         }
+
+        total += plans[kept].count;
+
+        slot = c->order[kept];
+        c->order[kept++] = c->order[i];
+        c->order[i] = slot;
+    }
+    c->alive = kept;
+
+    thin(c, plans, kept, total, c->sched.cap ? c->sched.cap : RIPPLE_RING_CAP);
+
+    for (uint8_t i = 0; i < kept; i++) {
+        r = &c->ripples[c->order[i]];
+
+        ripple(c, r, &plans[i]);
+
+        r->x += r->x_scroll;
+        r->y += r->y_scroll;
+    }
+
+    flushframe(c);
+
+    cost = elapsed(c, c->sched.last);
+
+#ifdef RIPPLE_STATS
+#ifdef QMK_EMULATOR
+    /* the emulated ms timer stands still while a frame is drawn */
+    us = (emu_now() - start) / 1000;
+#else
+    us = (uint32_t)cost * 1000;
+#endif
+    c->stats.frame_us += us;
+    c->stats.frame_us_max = MAX(c->stats.frame_us_max, us);
+#endif
+
+    schedule(c, cost);
+
+#if defined(RIPPLE_STATS) && defined(CONSOLE_ENABLE)
+    if (c == &ripple_default && STATS_INTERVAL && elapsed(c, c->reported) >= STATS_INTERVAL) {
+        ripple_stats_report(c);
     }
+#endif
+}
+
+void oled_write_ripples(void)
+{
+    ripple_ctx_render(&ripple_default);
 }
 #else
 enum empty { NIL };
@@ -8,9 +8,318 @@
 #include "emu/qmk.h"
 #endif
 
+#include "comp.h"
+
+/* maximum number of ripples */
+#ifndef RIPPLE_MAX
+#define RIPPLE_MAX 15
+#endif
+/* time between frames in ms */
+#ifndef RIPPLE_FRAMETIME
+#define RIPPLE_FRAMETIME 100
+#endif
+/* period of the ripple in ms */
+#ifndef RIPPLE_PERIOD
+#define RIPPLE_PERIOD 1500
+#endif
+/* wavelength of the ripple in px */
+#ifndef RIPPLE_WAVELENGTH
+#define RIPPLE_WAVELENGTH 15
+#endif
+/* time before ripple ceases */
+#ifndef RIPPLE_TIMEOUT
+#define RIPPLE_TIMEOUT 5000
+#endif
+/* ripple scroll speed x */
+#ifndef RIPPLE_SCROLL_X
+#define RIPPLE_SCROLL_X 0
+#endif
+/* ripple scroll speed y */
+#ifndef RIPPLE_SCROLL_Y
+#define RIPPLE_SCROLL_Y 0
+#endif
+/* ms a frame may take to draw before the scheduler backs off */
+#ifndef RIPPLE_BUDGET
+#define RIPPLE_BUDGET 8
+#endif
+/* longest time between frames the scheduler backs off to */
+#ifndef RIPPLE_FRAMETIME_MAX
+#define RIPPLE_FRAMETIME_MAX 400
+#endif
+/*
+ * a press within RIPPLE_MERGE_DIST px of a ripple less than
+ * RIPPLE_MERGE_AGE ms old spawns nothing, its rings would all but trace
+ * the young ripple's. 0 merges nothing.
+ */
+#ifndef RIPPLE_MERGE_AGE
+#define RIPPLE_MERGE_AGE 300
+#endif
+#ifndef RIPPLE_MERGE_DIST
+#define RIPPLE_MERGE_DIST 12
+#endif
+/*
+ * most rings drawn in a frame. past it the outer rings of the oldest
+ * ripples are thinned out first, then the oldest ripples altogether.
+ */
+#ifndef RIPPLE_RING_CAP
+#define RIPPLE_RING_CAP 24
+#endif
+/* ripples sent to the other half per transaction, 1 + 3 bytes each */
+#ifndef RIPPLE_SYNC_BATCH
+#define RIPPLE_SYNC_BATCH 8
+#endif
+/* ms between the stats printed to the console, 0 for never */
+#ifndef RIPPLE_STATS_INTERVAL
+#define RIPPLE_STATS_INTERVAL 10000
+#endif
+
+/* ring rasterizers */
+enum ripple_render {
+    /* bresenham, one pixel at a time */
+    RIPPLE_RENDER_PIXEL,
+    /* bresenham, gathered into page bytes */
+    RIPPLE_RENDER_BYTES,
+    /* precomputed ring bitmaps, needs RIPPLE_ATLAS */
+    RIPPLE_RENDER_ATLAS,
+    RIPPLE_RENDER_COUNT,
+};
+
+#ifndef RIPPLE_RENDER
+#ifdef RIPPLE_ATLAS
+#define RIPPLE_RENDER RIPPLE_RENDER_ATLAS
+#else
+#define RIPPLE_RENDER RIPPLE_RENDER_BYTES
+#endif
+#endif
+
+/* what ripple_add does once all RIPPLE_MAX ripples are alive */
+enum ripple_evict {
+    /* replace the oldest ripple */
+    RIPPLE_EVICT_OLDEST,
+    /* keep the old ripples, drop the new one */
+    RIPPLE_EVICT_NONE,
+};
+
+#ifndef RIPPLE_EVICT
+#define RIPPLE_EVICT RIPPLE_EVICT_OLDEST
+#endif
+
+#ifdef QMK_EMULATOR
+/* emulator builds can switch rasterizers at run time */
+extern uint8_t ripple_render;
+extern const char *const ripple_render_names[RIPPLE_RENDER_COUNT];
+/* and change RIPPLE_STATS_INTERVAL */
+extern uint16_t ripple_stats_interval;
+/* and RIPPLE_MERGE_AGE, 0 to merge nothing */
+extern uint16_t ripple_merge_age;
+#endif
+
+#ifdef RIPPLE_STATS
+typedef struct ripple_stats ripple_stats_t;
+
+/*
+ * work done by the renderer, clear it to start counting afresh. none
+ * of it is compiled in without RIPPLE_STATS.
+ */
+struct ripple_stats {
+    /* ripples replaced or refused by ripple_add when the pool is full */
+    uint32_t evicted;
+    uint32_t dropped;
+    /* presses merged into a young ripple nearby instead */
+    uint32_t merged;
+    /* ripples never sent to the other half, the batch was full */
+    uint32_t unsent;
+    /* frames drawn, and the ripples alive summed over them */
+    uint32_t frames;
+    uint32_t alive;
+    /* rings drawn, and rings skipped for being off the display */
+    uint32_t circles;
+    uint32_t culled;
+    /* rings not drawn to keep the frame within its ring cap */
+    uint32_t thinned;
+    /* bresenham steps, or atlas columns for blitted rings, walked */
+    uint32_t steps;
+    /* bytes or'd into the frame, and the pixels they set */
+    uint32_t writes;
+    uint32_t pixels;
+    /* pixels clipped one by one, rather than culled with their octant */
+    uint32_t clipped;
+    /* numbers drawn from the prng */
+    uint32_t rngs;
+    /* time spent drawing frames, and the longest frame */
+    uint32_t frame_us;
+    uint32_t frame_us_max;
+};
+#endif
+
+/* number of 8 row pages on the display */
+#define RIPPLE_PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+typedef struct ripple ripple_t;
+
+struct ripple {
+    uint8_t x;
+    uint8_t y;
+    int8_t x_scroll;
+    int8_t y_scroll;
+    uint16_t start;
+};
+
+typedef struct ripple_span ripple_span_t;
+
+/* columns [lo, hi) of a page that hold set bits, empty when lo >= hi */
+struct ripple_span {
+    uint8_t lo;
+    uint8_t hi;
+};
+
+typedef struct ripple_sched ripple_sched_t;
+
+/*
+ * frame pacing. a frame that takes longer than RIPPLE_BUDGET doubles
+ * the time to the next one, up to RIPPLE_FRAMETIME_MAX, and past that
+ * halves the rings drawn per frame. cheap frames undo that a step at a
+ * time, and an empty pool goes straight back to full rate and detail.
+ */
+struct ripple_sched {
+    /* when the last frame started */
+    uint16_t last;
+    /* ms between frames */
+    uint16_t frametime;
+    /* rings drawn per frame, 0 for RIPPLE_RING_CAP */
+    uint8_t cap;
+    /* frames over budget since the last report */
+    uint16_t overruns;
+};
+
+#ifdef RIPPLE_SYNC_ENABLE
+typedef struct ripple_pending ripple_pending_t;
+
+struct ripple_pending {
+    uint8_t x;
+    uint8_t y;
+    uint16_t start;
+};
+#endif
+
+typedef struct ripple_ctx ripple_ctx_t;
+
+/* the time in ms for a context, wrapping like timer_read */
+typedef uint16_t (*ripple_clock_t)(ripple_ctx_t *c);
+
+/*
+ * everything one engine needs, so several can run side by side. the
+ * fields belong to ripple.c, they are only here so contexts can be
+ * allocated statically.
+ */
+struct ripple_ctx {
+    ripple_clock_t clock;
+    /* told what changed in frame after every render, or NULL */
+    comp_layer_t *layer;
+    /*
+     * told where every ripple spawns, even one the full pool drops but
+     * not one merged into a young ripple, or NULL
+     */
+    void (*spawned)(uint8_t x, uint8_t y);
+    /*
+     * only tell spawned, keeping no ripples, for a context that is
+     * never rendered and would never let go of them
+     */
+    bool place_only;
+
+    /*
+     * the pool: order is a permutation of the slots in ripples, the
+     * first alive entries are the live ripples oldest first and the
+     * rest are the free slots. a frame only walks the live ones.
+     */
+    ripple_t ripples[RIPPLE_MAX];
+    uint8_t order[RIPPLE_MAX];
+    uint8_t alive;
+
+    ripple_sched_t sched;
+
+    /*
+     * page packed frame laid out like the display buffer, set before
+     * ripple_ctx_init, or NULL to draw straight into the display
+     */
+    uint8_t *frame;
+    /* columns drawn into the frame being rendered */
+    ripple_span_t drawn[RIPPLE_PAGES];
+    /* columns drawn into the frame the compositor has */
+    ripple_span_t shown[RIPPLE_PAGES];
+
+    /* xorshift16 state, never 0 */
+    uint16_t seed;
+
+#ifdef RIPPLE_FADE_NOISE
+    /* fade of the ripple being drawn, in percent of pixels dropped */
+    uint8_t dapple;
+#else
+    /* pixels kept at the current fade, one page byte for each x % 8 */
+    uint8_t fade[8];
+#endif
+
+#ifdef RIPPLE_SYNC_ENABLE
+    /* ripples spawned since the last ripple_sync_pack, oldest first */
+    ripple_pending_t outbox[RIPPLE_SYNC_BATCH];
+    uint8_t outbox_len;
+#endif
+
+#ifdef RIPPLE_STATS
+    ripple_stats_t stats;
+    /* when the stats were last printed */
+    uint16_t reported;
+#endif
+};
+
+/* reset an engine, seeding its prng from the clock. stats are left alone */
+void ripple_ctx_init(ripple_ctx_t *c, ripple_clock_t clock);
+/*
+ * seed an engine's prng, as ripple_ctx_init does from the clock. a run
+ * that needs the same ripples whatever the clock reads seeds it itself.
+ */
+void ripple_ctx_seed(ripple_ctx_t *c, uint16_t seed);
+/* start a ripple at x, y now, false when it was merged or dropped */
+bool ripple_ctx_add(ripple_ctx_t *c, uint8_t x, uint8_t y);
+/* draw a frame into c->frame, or the display, if one is due */
+void ripple_ctx_render(ripple_ctx_t *c);
+
+/* the engine behind the functions below, drawing the keyboard's display */
+ripple_ctx_t *ripple_ctx(void);
+
 void ripple_init(void);
+bool ripple_add(uint8_t x, uint8_t y);
 void process_record_ripples(keyrecord_t *record);
 void oled_write_ripples(void);
 
+/*
+ * the ripples as a compositor layer, oled_write_ripples is its update.
+ * they draw straight into the display, the bottom layer under layers
+ * that can only hide them. with RIPPLE_FRAME they draw into a frame of
+ * their own instead, another 1KB of ram, for a layer above that blends
+ * with them like pusheen's.
+ */
+extern comp_layer_t ripple_layer;
+
+#if defined(RIPPLE_STATS) && defined(CONSOLE_ENABLE)
+/*
+ * print an engine's stats as per frame averages and clear them. the
+ * keyboard's engine does this every RIPPLE_STATS_INTERVAL by itself.
+ */
+void ripple_stats_report(ripple_ctx_t *c);
+#endif
+
+#ifdef RIPPLE_SYNC_ENABLE
+/*
+ * the master spawns a ripple for every press, on both halves, and the
+ * slave only draws what it is sent. ripple_sync_pack fills buf with
+ * the ripples not sent yet and returns its length, 0 when there is
+ * nothing to send. ripple_sync_unpack spawns the ripples in a buffer
+ * from ripple_sync_pack.
+ */
+uint8_t ripple_sync_pack(uint8_t *buf, uint8_t size);
+void ripple_sync_unpack(const uint8_t *buf, uint8_t len);
+#endif
+
 #endif
 #endif // ripple_h_INCLUDED
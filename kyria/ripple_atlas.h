@@ -0,0 +1,513 @@
+#ifndef ripple_atlas_h_INCLUDED
+#define ripple_atlas_h_INCLUDED
+
+/* generated by emu/atlas.c, do not edit */
+
+#define RIPPLE_ATLAS_RADIUS 29
+
+static const uint8_t PROGMEM ripple_atlas[] = {
+    // r = 0
+    0x10, 0x01,
+    // r = 1
+    0x10, 0x02,
+    0x10, 0x01,
+    // r = 2
+    0x10, 0x04,
+    0x10, 0x04,
+    0x10, 0x03,
+    // r = 3
+    0x10, 0x08,
+    0x10, 0x08,
+    0x10, 0x04,
+    0x10, 0x03,
+    // r = 4
+    0x10, 0x10,
+    0x10, 0x10,
+    0x10, 0x08,
+    0x10, 0x04,
+    0x10, 0x03,
+    // r = 5
+    0x10, 0x20,
+    0x10, 0x20,
+    0x10, 0x10,
+    0x10, 0x08,
+    0x10, 0x04,
+    0x10, 0x03,
+    // r = 6
+    0x10, 0x40,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x20,
+    0x10, 0x10,
+    0x10, 0x0c,
+    0x10, 0x03,
+    // r = 7
+    0x10, 0x80,
+    0x10, 0x80,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x10,
+    0x10, 0x08,
+    0x10, 0x07,
+    // r = 8
+    0x11, 0x01,
+    0x11, 0x01,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x10,
+    0x10, 0x08,
+    0x10, 0x07,
+    // r = 9
+    0x11, 0x02,
+    0x11, 0x02,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x18,
+    0x10, 0x07,
+    // r = 10
+    0x11, 0x04,
+    0x11, 0x04,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x18,
+    0x10, 0x07,
+    // r = 11
+    0x11, 0x08,
+    0x11, 0x08,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x20,
+    0x10, 0x18,
+    0x10, 0x07,
+    // r = 12
+    0x11, 0x10,
+    0x11, 0x10,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x60,
+    0x10, 0x18,
+    0x10, 0x07,
+    // r = 13
+    0x11, 0x20,
+    0x11, 0x20,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x10,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0x80,
+    0x10, 0x40,
+    0x10, 0x38,
+    0x10, 0x07,
+    // r = 14
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x20, 0x80, 0x01,
+    0x10, 0x40,
+    0x10, 0x30,
+    0x10, 0x0f,
+    // r = 15
+    0x11, 0x80,
+    0x11, 0x80,
+    0x11, 0x80,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0xc0,
+    0x10, 0x30,
+    0x10, 0x0f,
+    // r = 16
+    0x12, 0x01,
+    0x12, 0x01,
+    0x12, 0x01,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x11, 0x01,
+    0x10, 0xc0,
+    0x10, 0x30,
+    0x10, 0x0f,
+    // r = 17
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x12, 0x01,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x03,
+    0x10, 0x80,
+    0x10, 0x70,
+    0x10, 0x0f,
+    // r = 18
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x04,
+    0x11, 0x02,
+    0x20, 0x80, 0x01,
+    0x10, 0x70,
+    0x10, 0x0f,
+    // r = 19
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x0c,
+    0x11, 0x02,
+    0x20, 0x80, 0x01,
+    0x10, 0x70,
+    0x10, 0x0f,
+    // r = 20
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x06,
+    0x20, 0x80, 0x01,
+    0x10, 0x70,
+    0x10, 0x0f,
+    // r = 21
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x08,
+    0x11, 0x06,
+    0x20, 0x80, 0x01,
+    0x10, 0x70,
+    0x10, 0x0f,
+    // r = 22
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x18,
+    0x11, 0x04,
+    0x11, 0x03,
+    0x10, 0xf0,
+    0x10, 0x0f,
+    // r = 23
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x20,
+    0x11, 0x10,
+    0x11, 0x0c,
+    0x11, 0x03,
+    0x10, 0xe0,
+    0x10, 0x1f,
+    // r = 24
+    0x13, 0x01,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x60,
+    0x11, 0x10,
+    0x11, 0x0c,
+    0x11, 0x03,
+    0x10, 0xe0,
+    0x10, 0x1f,
+    // r = 25
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x30,
+    0x11, 0x0c,
+    0x11, 0x03,
+    0x10, 0xe0,
+    0x10, 0x1f,
+    // r = 26
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x40,
+    0x11, 0x30,
+    0x11, 0x08,
+    0x11, 0x07,
+    0x10, 0xe0,
+    0x10, 0x1f,
+    // r = 27
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0xc0,
+    0x11, 0x20,
+    0x11, 0x18,
+    0x11, 0x07,
+    0x10, 0xe0,
+    0x10, 0x1f,
+    // r = 28
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x01,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x02,
+    0x12, 0x01,
+    0x11, 0x80,
+    0x11, 0x60,
+    0x11, 0x18,
+    0x11, 0x06,
+    0x20, 0xe0, 0x01,
+    0x10, 0x1f,
+    // r = 29
+    0x13, 0x20,
+    0x13, 0x20,
+    0x13, 0x20,
+    0x13, 0x20,
+    0x13, 0x20,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x10,
+    0x13, 0x08,
+    0x13, 0x08,
+    0x13, 0x04,
+    0x13, 0x04,
+    0x13, 0x02,
+    0x13, 0x02,
+    0x13, 0x01,
+    0x12, 0x80,
+    0x12, 0x80,
+    0x12, 0x40,
+    0x12, 0x20,
+    0x12, 0x10,
+    0x12, 0x08,
+    0x12, 0x04,
+    0x12, 0x03,
+    0x11, 0x80,
+    0x11, 0x60,
+    0x11, 0x18,
+    0x11, 0x06,
+    0x20, 0xe0, 0x01,
+    0x10, 0x1f,
+};
+
+static const uint16_t PROGMEM ripple_atlas_index[] = {
+    0, 2, 6, 12, 20, 30, 42, 56,
+    72, 90, 110, 132, 156, 182, 210, 241,
+    273, 307, 343, 382, 423, 466, 511, 557,
+    605, 655, 707, 761, 817, 876,
+};
+
+#endif // ripple_atlas_h_INCLUDED
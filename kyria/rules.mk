@@ -7,4 +7,65 @@ RGBLIGHT_ENABLE = yes      # Enable keyboard RGB underglow
 # see: squeezing_avr.md
 LTO_ENABLE = yes
 
-SRC += ripple.c
+SRC += comp.c ripple.c
+
+# both halves show every press, the master sends the slave its ripples
+# over a split transaction. only run in the emulator so far, without it
+# each half shows the presses on its own keys
+RIPPLE_SYNC_ENABLE ?= no
+ifeq ($(strip $(RIPPLE_SYNC_ENABLE)), yes)
+    OPT_DEFS += -DRIPPLE_SYNC_ENABLE
+endif
+
+# blit rings up to emu/config.mk's ATLAS_RADIUS from a precomputed
+# bitmap atlas, ~1KB of flash at the default radius of 29
+# OPT_DEFS += -DRIPPLE_ATLAS
+
+# fade rings with random noise instead of the ordered dither
+# OPT_DEFS += -DRIPPLE_FADE_NOISE
+
+# count what the ripple renderer does, printed to the console every
+# RIPPLE_STATS_INTERVAL ms with CONSOLE_ENABLE
+# OPT_DEFS += -DRIPPLE_STATS
+
+# waves on a heightfield instead of the ripples' circles, see water.h.
+# it draws where the ripples would, and needs another ~280 bytes of
+# ram at the default WATER_SHIFT of 3, or 1KB at 2
+# WATER_ENABLE = yes
+ifeq ($(strip $(WATER_ENABLE)), yes)
+    SRC += water.c
+    OPT_DEFS += -DWATER_ENABLE
+endif
+
+# the layer, mods held and lock leds along the bottom of the display,
+# drawn only when they change, see widget.h. ~110 bytes of ram for
+# their buffers
+# STATUS_ENABLE = yes
+ifeq ($(strip $(STATUS_ENABLE)), yes)
+    OPT_DEFS += -DSTATUS_ENABLE
+endif
+
+# the typing speed over the last few seconds and a heatmap of the keys
+# pressed lately across the top of the display, and on the console
+# with CONSOLE_ENABLE, see keystats.h. ~100 bytes of ram and 200 more
+# for drawing them
+# KEYSTATS_ENABLE = yes
+ifeq ($(strip $(KEYSTATS_ENABLE)), yes)
+    SRC += keystats.c
+    OPT_DEFS += -DKEYSTATS_ENABLE
+endif
+
+# both of the above draw text with widget.c
+ifneq ($(filter yes, $(strip $(STATUS_ENABLE)) $(strip $(KEYSTATS_ENABLE))),)
+    SRC += widget.c
+endif
+
+# play the pusheen animation over the ripples, it needs another
+# 512 bytes of ram. it inverts the ripples under it, so they need
+# another 1KB for a frame of their own instead of drawing straight
+# into the display
+# PUSHEEN_ENABLE = yes
+ifeq ($(strip $(PUSHEEN_ENABLE)), yes)
+    SRC += anim.c
+    OPT_DEFS += -DPUSHEEN_ENABLE -DRIPPLE_FRAME
+endif
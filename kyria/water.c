@@ -0,0 +1,387 @@
+#ifdef OLED_ENABLE
+#include "water.h"
+
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#if WATER_SHIFT < 0 || WATER_SHIFT > 3
+#error "WATER_SHIFT must be 0 to 3, a cell can't span pages"
+#endif
+#if WATER_DAMP < 1 || WATER_DAMP > 7
+#error "WATER_DAMP must be 1 to 7"
+#endif
+
+#define PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+#ifdef QMK_EMULATOR
+uint8_t water_shift = WATER_SHIFT;
+bool water_words = true;
+
+#define SHIFT water_shift
+/* room for the finest cells, whatever water_shift is */
+#define CELLS (OLED_DISPLAY_WIDTH * OLED_DISPLAY_HEIGHT)
+#else
+#define SHIFT WATER_SHIFT
+#define CELLS ((OLED_DISPLAY_WIDTH >> WATER_SHIFT) * (OLED_DISPLAY_HEIGHT >> WATER_SHIFT))
+#endif
+
+#define COLS (OLED_DISPLAY_WIDTH >> SHIFT)
+#define ROWS (OLED_DISPLAY_HEIGHT >> SHIFT)
+
+/*
+ * where a machine word holds several cells, they are stepped a word at
+ * a time, see stepwords. not on the avr, whose words hold two.
+ */
+#if UINTPTR_MAX > 0xffff
+#define WATER_WORDS
+#endif
+
+#ifdef QMK_EMULATOR
+#define WORDS water_words
+#elif defined(WATER_WORDS)
+#define WORDS true
+#else
+#define WORDS false
+#endif
+
+comp_layer_t water_layer = {
+    .name = "water",
+    .width = OLED_DISPLAY_WIDTH,
+    .pages = PAGES,
+    .blend = COMP_OR,
+    .update = water_task,
+};
+
+/*
+ * two heightfields, cells[now] at this frame and the other at the one
+ * before, which the next step overwrites in place. the cells on the
+ * edges are the walls of the pond, always 0.
+ */
+static int8_t cells[2][CELLS];
+static uint8_t now;
+
+/* when the last frame was drawn and the last drop fell */
+static uint16_t last;
+static uint16_t dropped;
+/* every cell is 0 and the frame is blank, nothing to do */
+static bool still;
+
+/*
+ * 17 levels of the 4x4 corner of ripple.c's bayer matrix, one page
+ * byte for each x % 4. level n lights n of every 16 pixels.
+ */
+static const uint8_t PROGMEM dither[17][4] = {
+    { 0x00, 0x00, 0x00, 0x00 },
+    { 0x11, 0x00, 0x00, 0x00 },
+    { 0x11, 0x00, 0x44, 0x00 },
+    { 0x11, 0x00, 0x55, 0x00 },
+    { 0x55, 0x00, 0x55, 0x00 },
+    { 0x55, 0x22, 0x55, 0x00 },
+    { 0x55, 0x22, 0x55, 0x88 },
+    { 0x55, 0x22, 0x55, 0xaa },
+    { 0x55, 0xaa, 0x55, 0xaa },
+    { 0x55, 0xbb, 0x55, 0xaa },
+    { 0x55, 0xbb, 0x55, 0xee },
+    { 0x55, 0xbb, 0x55, 0xff },
+    { 0x55, 0xff, 0x55, 0xff },
+    { 0x77, 0xff, 0x55, 0xff },
+    { 0x77, 0xff, 0xdd, 0xff },
+    { 0x77, 0xff, 0xff, 0xff },
+    { 0xff, 0xff, 0xff, 0xff },
+};
+
+static inline int8_t clamp(int16_t v)
+{
+    if (v < INT8_MIN) {
+        return INT8_MIN;
+    }
+    if (v > INT8_MAX) {
+        return INT8_MAX;
+    }
+
+    return v;
+}
+
+void water_init(uint8_t *frame)
+{
+    water_layer.buf = frame;
+
+    memset(cells, 0, sizeof(cells));
+    now = 0;
+    still = true;
+
+    if (frame) {
+        memset(frame, 0, OLED_MATRIX_SIZE);
+    } else {
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            if (!comp_hidden(i / OLED_DISPLAY_WIDTH, i % OLED_DISPLAY_WIDTH)) {
+                oled_write_raw_byte(0, i);
+            }
+        }
+    }
+    for (uint8_t page = 0; page < PAGES; page++) {
+        comp_dirty(&water_layer, page, 0, OLED_DISPLAY_WIDTH);
+    }
+}
+
+/*
+ * a cell's depth goes down by d, and its 4 neighbours' by half that,
+ * away from the walls
+ */
+void water_drop(uint8_t x, uint8_t y)
+{
+    int8_t *h = cells[now];
+    uint16_t i;
+    uint8_t cx, cy;
+
+    cx = MIN(MAX(x >> SHIFT, 1), COLS - 2);
+    cy = MIN(MAX(y >> SHIFT, 1), ROWS - 2);
+    i = cy * COLS + cx;
+
+    h[i] = clamp(h[i] - WATER_DROP);
+    h[i - 1] = clamp(h[i - 1] - WATER_DROP / 2);
+    h[i + 1] = clamp(h[i + 1] - WATER_DROP / 2);
+    h[i - COLS] = clamp(h[i - COLS] - WATER_DROP / 2);
+    h[i + COLS] = clamp(h[i + COLS] - WATER_DROP / 2);
+
+    /* walls stay put */
+    if (cx == 1) {
+        h[i - 1] = 0;
+    }
+    if (cx == COLS - 2) {
+        h[i + 1] = 0;
+    }
+    if (cy == 1) {
+        h[i - COLS] = 0;
+    }
+    if (cy == ROWS - 2) {
+        h[i + COLS] = 0;
+    }
+
+    dropped = timer_read();
+    if (still) {
+        still = false;
+        last = dropped - WATER_FRAMETIME;
+    }
+}
+
+/*
+ * the classic two buffer wave: a cell's next height is half the sum of
+ * its neighbours now, less its height a frame ago, damped. shifts and
+ * adds only, in 16 bits and clamped back into the cell.
+ */
+static void steprow(int8_t *next, const int8_t *h)
+{
+    int16_t v;
+
+    for (uint8_t x = 1; x < COLS - 1; x++) {
+        v = ((h[x - 1] + h[x + 1] + h[x - COLS] + h[x + COLS]) >> 1) - next[x];
+        v -= v >> WATER_DAMP;
+
+        next[x] = clamp(v);
+    }
+}
+
+#ifdef WATER_WORDS
+typedef uintptr_t word_t;
+
+/* a 1 in each 16 bit lane of a word */
+#define LANES ((word_t)-1 / 0xffff)
+
+static inline word_t load(const int8_t *p)
+{
+    word_t w;
+
+    memcpy(&w, p, sizeof(w));
+
+    return w;
+}
+
+/*
+ * steprow on the even or odd bytes of a word of cells, each offset by
+ * 128 and widened to a 16 bit lane. every sum below is kept positive
+ * with a bias, so the lanes never carry into each other.
+ */
+static inline word_t steplanes(word_t w, word_t e, word_t n, word_t s, word_t p)
+{
+    word_t v;
+    word_t hi;
+    word_t lo;
+
+    /* the sum of the neighbours is 4 * 128 over, halve it */
+    v = ((w + e + n + s) >> 1) & (LANES * 0x7fff);
+    /* now 256 over, and less p is 128 under, so 384 over in all */
+    v = v + LANES * 256 - p;
+    /* damped as in steprow, 384 is a multiple of 2^WATER_DAMP */
+    v = v - ((v >> WATER_DAMP) & (LANES * (0xffff >> WATER_DAMP))) + LANES * (384 >> WATER_DAMP);
+
+    /* clamp to -128 and 127, 256 and 511 over 384, by the sign of v - limit */
+    hi = ((v + LANES * (0x8000 - 512)) >> 15) & LANES;
+    v = (v & ~(hi * 0xffff)) | hi * 511;
+    lo = ((v + LANES * (0x8000 - 256)) >> 15) & LANES;
+    v = (v & lo * 0xffff) | (lo ^ LANES) * 256;
+
+    /* 128 over, like the input */
+    return v - LANES * 256;
+}
+
+/*
+ * steprow a word of cells at a time, exactly. the words overlap the
+ * walls, which are zeroed again after, and the first and last read a
+ * cell either side of the row, which is still inside the buffer.
+ */
+static void stepwords(int8_t *next, const int8_t *h)
+{
+    const word_t bias = LANES * 0x8080;
+    const word_t even = LANES * 0x00ff;
+    word_t w, e, n, s, p;
+
+    for (uint8_t x = 0; x < COLS; x += sizeof(word_t)) {
+        w = load(&h[x - 1]) ^ bias;
+        e = load(&h[x + 1]) ^ bias;
+        n = load(&h[x - COLS]) ^ bias;
+        s = load(&h[x + COLS]) ^ bias;
+        p = load(&next[x]) ^ bias;
+
+        p = steplanes(w & even, e & even, n & even, s & even, p & even)
+            | steplanes(w >> 8 & even, e >> 8 & even, n >> 8 & even, s >> 8 & even, p >> 8 & even) << 8;
+        p ^= bias;
+
+        memcpy(&next[x], &p, sizeof(p));
+    }
+
+    next[0] = 0;
+    next[COLS - 1] = 0;
+}
+#endif
+
+void water_step(void)
+{
+    const int8_t *h = cells[now];
+    int8_t *next = cells[!now];
+
+    for (uint16_t i = COLS; i < (ROWS - 1) * COLS; i += COLS) {
+#ifdef WATER_WORDS
+        if (WORDS && COLS % sizeof(word_t) == 0) {
+            stepwords(&next[i], &h[i]);
+            continue;
+        }
+#endif
+        steprow(&next[i], &h[i]);
+    }
+
+    now = !now;
+}
+
+/*
+ * the brightness of a cell, lit from the top left: how much higher
+ * the neighbours on that side are, in steps of 2^WATER_LIGHT
+ */
+static inline uint8_t light(const int8_t *h, uint8_t cx, uint8_t cy)
+{
+    uint16_t i;
+    int16_t slope;
+
+    if (cx == 0 || cx == COLS - 1 || cy == 0 || cy == ROWS - 1) {
+        return 0;
+    }
+
+    i = cy * COLS + cx;
+    slope = h[i - 1] - h[i + 1] + h[i - COLS] - h[i + COLS];
+    if (slope <= 0) {
+        return 0;
+    }
+
+    return MIN(slope >> WATER_LIGHT, 16);
+}
+
+void water_render(void)
+{
+    const int8_t *h = cells[now];
+    uint8_t *row;
+    uint16_t base;
+    uint8_t level[8];
+    uint8_t size;
+    uint8_t per;
+    uint8_t mask;
+    uint8_t bits;
+    uint8_t lo, hi;
+    uint8_t x;
+
+    /* px a cell is wide and high, and cells stacked in a page */
+    size = 1 << SHIFT;
+    per = 8 >> SHIFT;
+    mask = (1 << size) - 1;
+
+    for (uint8_t page = 0; page < PAGES; page++) {
+        base = page * OLED_DISPLAY_WIDTH;
+        row = water_layer.buf ? &water_layer.buf[base] : oled_read_raw(base).current_element;
+        lo = OLED_DISPLAY_WIDTH;
+        hi = 0;
+
+        for (uint8_t cx = 0; cx < COLS; cx++) {
+            for (uint8_t k = 0; k < per; k++) {
+                level[k] = light(h, cx, page * per + k);
+            }
+
+            for (uint8_t dx = 0; dx < size; dx++) {
+                x = (cx << SHIFT) + dx;
+
+                bits = 0;
+                for (uint8_t k = 0; k < per; k++) {
+                    bits |= pgm_read_byte(&dither[level[k]][x % 4]) & (mask << (k << SHIFT));
+                }
+
+                /* drawing into the display, leave what's hidden alone */
+                if (row[x] == bits || (!water_layer.buf && comp_hidden(page, x))) {
+                    continue;
+                }
+
+                if (water_layer.buf) {
+                    row[x] = bits;
+                } else {
+                    oled_write_raw_byte(bits, base + x);
+                }
+                lo = MIN(lo, x);
+                hi = x + 1;
+            }
+        }
+
+        comp_dirty(&water_layer, page, lo, hi);
+    }
+}
+
+void water_task(void)
+{
+    if (still || timer_elapsed(last) < WATER_FRAMETIME) {
+        return;
+    }
+
+    last = timer_read();
+
+    /* long after the last drop, what's left is too faint to see */
+    if (timer_elapsed(dropped) > WATER_TIMEOUT) {
+        memset(cells, 0, sizeof(cells));
+        still = true;
+    } else {
+        water_step();
+    }
+
+    water_render();
+}
+
+#ifdef QMK_EMULATOR
+const int8_t *water_cells(void)
+{
+    return cells[now];
+}
+#endif
+#else
+enum empty { NIL };
+#endif
@@ -0,0 +1,73 @@
+#ifndef water_h_INCLUDED
+#define water_h_INCLUDED
+
+#ifdef OLED_ENABLE
+#ifndef QMK_EMULATOR
+#include QMK_KEYBOARD_H
+#else
+#include "emu/qmk.h"
+#endif
+
+#include "comp.h"
+
+/*
+ * cells are 2^WATER_SHIFT px square, 0 to 3. the two heightfields take
+ * (OLED_DISPLAY_WIDTH >> WATER_SHIFT) * (OLED_DISPLAY_HEIGHT >> WATER_SHIFT)
+ * bytes each, 256 bytes for both at the default and 1KB at 2.
+ */
+#ifndef WATER_SHIFT
+#define WATER_SHIFT 3
+#endif
+/* time between frames in ms, the waves move up to a cell per frame */
+#ifndef WATER_FRAMETIME
+#define WATER_FRAMETIME 50
+#endif
+/* waves lose 1 / 2^WATER_DAMP of their height per frame, 1 to 7 */
+#ifndef WATER_DAMP
+#define WATER_DAMP 4
+#endif
+/* how deep a drop pushes the water in, up to 128 */
+#ifndef WATER_DROP
+#define WATER_DROP 120
+#endif
+/* slopes are lit in steps of 2^WATER_LIGHT, smaller is brighter */
+#ifndef WATER_LIGHT
+#define WATER_LIGHT 2
+#endif
+/* time after the last drop before the water is stilled */
+#ifndef WATER_TIMEOUT
+#define WATER_TIMEOUT 5000
+#endif
+
+#ifdef QMK_EMULATOR
+/* emulator builds can change WATER_SHIFT at run time, before water_init */
+extern uint8_t water_shift;
+/* and step the cells a word at a time or one by one */
+extern bool water_words;
+#endif
+
+/*
+ * start with still water, drawn into frame. frame is OLED_MATRIX_SIZE
+ * bytes laid out like the display buffer, and becomes water_layer's,
+ * or NULL to draw straight into the display as the bottom layer.
+ */
+void water_init(uint8_t *frame);
+/* drop something in the water at x, y on the display */
+void water_drop(uint8_t x, uint8_t y);
+/* move the waves on a frame */
+void water_step(void);
+/* draw the waves into the frame, marking the columns that changed */
+void water_render(void);
+/* step and draw if a frame is due, it's water_layer's update */
+void water_task(void);
+
+#ifdef QMK_EMULATOR
+/* the current heightfield, row by row */
+const int8_t *water_cells(void);
+#endif
+
+/* the water as a compositor layer */
+extern comp_layer_t water_layer;
+
+#endif
+#endif // water_h_INCLUDED
@@ -0,0 +1,145 @@
+#ifdef OLED_ENABLE
+#include "widget.h"
+
+#include <string.h>
+
+#define GLYPH_COLUMNS 5
+
+/*
+ * 5x7 glyphs already in page bytes, so drawing a char is copying its
+ * columns. the order is the one glyph() maps chars to.
+ */
+static const uint8_t PROGMEM glyphs[][GLYPH_COLUMNS] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, /*   */
+    { 0x3e, 0x51, 0x49, 0x45, 0x3e }, /* 0 */
+    { 0x00, 0x42, 0x7f, 0x40, 0x00 }, /* 1 */
+    { 0x42, 0x61, 0x51, 0x49, 0x46 }, /* 2 */
+    { 0x21, 0x41, 0x45, 0x4b, 0x31 }, /* 3 */
+    { 0x18, 0x14, 0x12, 0x7f, 0x10 }, /* 4 */
+    { 0x27, 0x45, 0x45, 0x45, 0x39 }, /* 5 */
+    { 0x3c, 0x4a, 0x49, 0x49, 0x30 }, /* 6 */
+    { 0x01, 0x71, 0x09, 0x05, 0x03 }, /* 7 */
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, /* 8 */
+    { 0x06, 0x49, 0x49, 0x29, 0x1e }, /* 9 */
+    { 0x7e, 0x11, 0x11, 0x11, 0x7e }, /* A */
+    { 0x7f, 0x49, 0x49, 0x49, 0x36 }, /* B */
+    { 0x3e, 0x41, 0x41, 0x41, 0x22 }, /* C */
+    { 0x7f, 0x41, 0x41, 0x22, 0x1c }, /* D */
+    { 0x7f, 0x49, 0x49, 0x49, 0x41 }, /* E */
+    { 0x7f, 0x09, 0x09, 0x09, 0x01 }, /* F */
+    { 0x3e, 0x41, 0x49, 0x49, 0x7a }, /* G */
+    { 0x7f, 0x08, 0x08, 0x08, 0x7f }, /* H */
+    { 0x00, 0x41, 0x7f, 0x41, 0x00 }, /* I */
+    { 0x20, 0x40, 0x41, 0x3f, 0x01 }, /* J */
+    { 0x7f, 0x08, 0x14, 0x22, 0x41 }, /* K */
+    { 0x7f, 0x40, 0x40, 0x40, 0x40 }, /* L */
+    { 0x7f, 0x02, 0x0c, 0x02, 0x7f }, /* M */
+    { 0x7f, 0x04, 0x08, 0x10, 0x7f }, /* N */
+    { 0x3e, 0x41, 0x41, 0x41, 0x3e }, /* O */
+    { 0x7f, 0x09, 0x09, 0x09, 0x06 }, /* P */
+    { 0x3e, 0x41, 0x51, 0x21, 0x5e }, /* Q */
+    { 0x7f, 0x09, 0x19, 0x29, 0x46 }, /* R */
+    { 0x46, 0x49, 0x49, 0x49, 0x31 }, /* S */
+    { 0x01, 0x01, 0x7f, 0x01, 0x01 }, /* T */
+    { 0x3f, 0x40, 0x40, 0x40, 0x3f }, /* U */
+    { 0x1f, 0x20, 0x40, 0x20, 0x1f }, /* V */
+    { 0x3f, 0x40, 0x38, 0x40, 0x3f }, /* W */
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, /* X */
+    { 0x07, 0x08, 0x70, 0x08, 0x07 }, /* Y */
+    { 0x61, 0x51, 0x49, 0x45, 0x43 }, /* Z */
+    { 0x08, 0x08, 0x08, 0x08, 0x08 }, /* - */
+    { 0x00, 0x60, 0x60, 0x00, 0x00 }, /* . */
+    { 0x20, 0x10, 0x08, 0x04, 0x02 }, /* / */
+    { 0x00, 0x36, 0x36, 0x00, 0x00 }, /* : */
+    { 0x23, 0x13, 0x08, 0x64, 0x62 }, /* % */
+};
+
+#define GLYPH_DIGITS 1
+#define GLYPH_LETTERS (GLYPH_DIGITS + 10)
+#define GLYPH_SYMBOLS (GLYPH_LETTERS + 26)
+
+static const char PROGMEM symbols[] = "-./:%";
+
+static uint8_t glyph(char ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return GLYPH_DIGITS + ch - '0';
+    }
+    if (ch >= 'A' && ch <= 'Z') {
+        return GLYPH_LETTERS + ch - 'A';
+    }
+    if (ch >= 'a' && ch <= 'z') {
+        return GLYPH_LETTERS + ch - 'a';
+    }
+
+    for (uint8_t i = 0; i < sizeof(symbols) - 1; i++) {
+        if (ch == (char)pgm_read_byte(&symbols[i])) {
+            return GLYPH_SYMBOLS + i;
+        }
+    }
+
+    return 0;
+}
+
+void widget_init(widget_t *w)
+{
+    w->drawn = false;
+}
+
+void widget_update(widget_t *w)
+{
+    comp_layer_t *l = w->layer;
+    char text[WIDGET_CHARS];
+    uint16_t value;
+    uint8_t inverse;
+    uint8_t chars;
+    uint8_t mask;
+    uint8_t lo;
+    uint8_t hi;
+    uint8_t *dst;
+    uint8_t b;
+    uint8_t g;
+
+    value = w->read();
+    if (w->drawn && value == w->value) {
+        return;
+    }
+
+    w->value = value;
+    w->drawn = true;
+
+    chars = l->width / WIDGET_GLYPH;
+    if (chars > WIDGET_CHARS) {
+        chars = WIDGET_CHARS;
+    }
+
+    memset(text, ' ', sizeof(text));
+    inverse = w->format(value, text);
+
+    /* only the columns that came out different are recomposited */
+    lo = l->width;
+    hi = 0;
+    dst = l->buf;
+    for (uint8_t i = 0; i < chars; i++) {
+        g = glyph(text[i]);
+        mask = inverse & (1 << i) ? 0xff : 0x00;
+
+        for (uint8_t x = 0; x < WIDGET_GLYPH; x++, dst++) {
+            b = x < GLYPH_COLUMNS ? pgm_read_byte(&glyphs[g][x]) : 0;
+            b ^= mask;
+
+            if (*dst != b) {
+                *dst = b;
+                if (lo > dst - l->buf) {
+                    lo = dst - l->buf;
+                }
+                hi = dst - l->buf + 1;
+            }
+        }
+    }
+
+    comp_dirty(l, 0, lo, hi);
+}
+#else
+enum empty { NIL };
+#endif
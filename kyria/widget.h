@@ -0,0 +1,50 @@
+#ifndef widget_h_INCLUDED
+#define widget_h_INCLUDED
+
+#ifdef OLED_ENABLE
+#ifndef QMK_EMULATOR
+#include QMK_KEYBOARD_H
+#else
+#include "emu/qmk.h"
+#endif
+
+#include "comp.h"
+
+/*
+ * a glyph is 5 columns of a page byte, bit 0 at the top, and a blank
+ * column after it. glyphs exist for the space, digits, upper case
+ * letters and - . / : %, lower case is drawn upper case and anything
+ * else as a space.
+ */
+#define WIDGET_GLYPH 6
+/* most chars in a widget, one bit each in format's inverse mask */
+#define WIDGET_CHARS 8
+
+typedef struct widget widget_t;
+
+/*
+ * a line of text in a one page layer of chars * WIDGET_GLYPH columns.
+ * the text only changes with the value read, so a widget draws nothing
+ * while its value stays the same.
+ */
+struct widget {
+    /* the value the text shows, right now */
+    uint16_t (*read)(void);
+    /*
+     * write a value's text, padded with spaces to the widget's chars,
+     * and return a bit per char for the ones drawn inverted
+     */
+    uint8_t (*format)(uint16_t value, char *text);
+    comp_layer_t *layer;
+
+    uint16_t value;
+    bool drawn;
+};
+
+/* draw the widget afresh on its next update */
+void widget_init(widget_t *w);
+/* draw the text if the value changed, marking the columns that did */
+void widget_update(widget_t *w);
+
+#endif
+#endif // widget_h_INCLUDED